@@ -1,8 +1,164 @@
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <barrier>
+#include <bit>
+#include <charconv>
+#include <chrono>
+#include <cmath>
 #include <complex>
+#include <cstdint>
+#include <exception>
+#include <initializer_list>
 #include <iostream>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <random>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
+// BIGINTEGER_USE_GMP keeps each BigInteger in an mpz_class and runs the arithmetic on GMP's kernels behind the same
+// API; the extensions below that work on limbs switch to the matching mpz calls.
+#ifdef BIGINTEGER_USE_GMP
+#ifdef BIGINTEGER_SHARED_LIMBS
+#error "BIGINTEGER_SHARED_LIMBS cannot be combined with BIGINTEGER_USE_GMP"
+#endif
+#include <gmpxx.h>
+#endif
+
+#ifdef BIGINTEGER_INSTRUMENTATION
+
+namespace bigint_stats {
+    enum class Operation { Multiply, DivMod, Gcd, ToString, Read, Reduce, Count };
+
+    constexpr size_t OPERATION_COUNT = static_cast<size_t>(Operation::Count);
+    constexpr size_t HISTOGRAM_SIZE = 65;
+
+    inline const char* name(Operation op) {
+        static const char* const names[OPERATION_COUNT] = {
+            "operator*=", "div_mod", "gcd", "toString", "operator>>", "Rational::reduce"};
+        return names[static_cast<size_t>(op)];
+    }
+
+    // estimated_allocations is not measured: it adds up the buffers each operation is expected to create or grow,
+    // as annotated at the call sites, and misses anything the standard library allocates on its own.
+    struct OperationStats {
+        std::atomic<uint64_t> calls{0};
+        std::atomic<uint64_t> limbs{0};
+        std::atomic<uint64_t> estimated_allocations{0};
+        std::atomic<uint64_t> nanoseconds{0};
+        std::array<std::atomic<uint64_t>, HISTOGRAM_SIZE> histogram{};
+    };
+
+    inline std::array<OperationStats, OPERATION_COUNT>& table() {
+        static std::array<OperationStats, OPERATION_COUNT> stats;
+        return stats;
+    }
+
+    inline std::atomic<uint64_t>& fft_fallbacks() {
+        static std::atomic<uint64_t> count{0};
+        return count;
+    }
+
+    inline const OperationStats& get(Operation op) {
+        return table()[static_cast<size_t>(op)];
+    }
+
+    inline void reset() {
+        for (auto& stats : table()) {
+            stats.calls = 0;
+            stats.limbs = 0;
+            stats.estimated_allocations = 0;
+            stats.nanoseconds = 0;
+            for (auto& bucket : stats.histogram) {
+                bucket = 0;
+            }
+        }
+        fft_fallbacks() = 0;
+    }
+
+    inline void dump(std::ostream& out) {
+        for (size_t i = 0; i < OPERATION_COUNT; ++i) {
+            const OperationStats& stats = table()[i];
+            uint64_t calls = stats.calls;
+            if (calls == 0) {
+                continue;
+            }
+            out << name(static_cast<Operation>(i)) << ": calls " << calls
+                << ", limbs " << stats.limbs << ", estimated allocations " << stats.estimated_allocations
+                << ", time " << stats.nanoseconds / 1000 << "us\n";
+            for (size_t bucket = 0; bucket < HISTOGRAM_SIZE; ++bucket) {
+                if (uint64_t count = stats.histogram[bucket]) {
+                    out << "    limbs < 2^" << bucket << ": " << count << '\n';
+                }
+            }
+        }
+        if (uint64_t count = fft_fallbacks()) {
+            out << "FFT fallbacks to schoolbook: " << count << '\n';
+        }
+    }
+
+    class Scope {
+    public:
+        Scope(Operation op, size_t limbs)
+            : stats(table()[static_cast<size_t>(op)])
+            , operand_limbs(limbs)
+            , start(std::chrono::steady_clock::now()) {}
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+        ~Scope() {
+            auto elapsed = std::chrono::steady_clock::now() - start;
+            auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+            stats.calls.fetch_add(1, std::memory_order_relaxed);
+            stats.limbs.fetch_add(operand_limbs, std::memory_order_relaxed);
+            stats.histogram[static_cast<size_t>(64 - std::countl_zero(operand_limbs))].fetch_add(1, std::memory_order_relaxed);
+            stats.nanoseconds.fetch_add(static_cast<uint64_t>(ns), std::memory_order_relaxed);
+        }
+
+        void limbs(size_t count) {
+            operand_limbs = count;
+        }
+
+        void allocation(size_t count = 1) {
+            stats.estimated_allocations.fetch_add(count, std::memory_order_relaxed);
+        }
+        void growth(size_t old_capacity, size_t new_capacity) {
+            if (new_capacity != old_capacity) {
+                allocation();
+            }
+        }
+
+    private:
+        OperationStats& stats;
+        size_t operand_limbs;
+        std::chrono::steady_clock::time_point start;
+    };
+}
+
+#define BIGINTEGER_PROFILE(op, limbs) bigint_stats::Scope bigint_profile_scope(bigint_stats::Operation::op, limbs)
+#define BIGINTEGER_NOTE_ALLOCATION(count) bigint_profile_scope.allocation(count)
+#define BIGINTEGER_NOTE_GROWTH(old_capacity, new_capacity) bigint_profile_scope.growth(old_capacity, new_capacity)
+#define BIGINTEGER_NOTE_LIMBS(count) bigint_profile_scope.limbs(count)
+#define BIGINTEGER_NOTE_FFT_FALLBACK() bigint_stats::fft_fallbacks().fetch_add(1, std::memory_order_relaxed)
+#else
+#define BIGINTEGER_PROFILE(op, limbs)
+#define BIGINTEGER_NOTE_ALLOCATION(count)
+#define BIGINTEGER_NOTE_GROWTH(old_capacity, new_capacity)
+#define BIGINTEGER_NOTE_LIMBS(count)
+#define BIGINTEGER_NOTE_FFT_FALLBACK()
+#endif
+
+#ifndef BIGINTEGER_USE_GMP
 namespace {
     const long double pi = 2 * asinl(1);
 
@@ -14,54 +170,486 @@ namespace {
         return m;
     }
 
-    void fft(std::vector<std::complex<long double>>& digits, bool invert) {
-        for (size_t i = 1, j = 0; i < digits.size(); ++i) {
-            size_t bit = digits.size() >> 1;
-            for (; j >= bit; bit >>= 1) {
-                j -= bit;
+    using Complex = std::complex<double>;
+
+    // Complex product without the library's infinity / NaN recovery, which blocks vectorization.
+    Complex times(Complex a, Complex b) {
+        return {a.real() * b.real() - a.imag() * b.imag(), a.real() * b.imag() + a.imag() * b.real()};
+    }
+
+    // Transforms at most this many points breadth-first; larger blocks recurse so every pass stays in cache.
+    const size_t FFT_CACHE_BLOCK = 1 << 12;
+    // Lengths 3 * 2^k are used only when the power-of-two blocks are at least this long.
+    const size_t FFT_MIXED_BLOCK = 64;
+
+    // Smallest transform length >= len: a power of two, or three times one when that is shorter.
+    size_t fftLength(size_t len) {
+        size_t pow2 = to_pow2(std::max<size_t>(len, 2));
+        return pow2 / 4 >= FFT_MIXED_BLOCK && 3 * (pow2 / 4) >= len ? 3 * (pow2 / 4) : pow2;
+    }
+
+    // out[j] = exp(2 pi i j / n) for j < n / 2, where n is a power of two or divisible by 8. Only the first
+    // octant needs trigonometry; the rest of the half circle follows by symmetry.
+    void fillRoots(Complex* out, size_t n) {
+        size_t quarter = n / 4;
+        for (size_t j = 0; j <= quarter / 2; ++j) {
+            long double angle = 2 * pi * static_cast<long double>(j) / static_cast<long double>(n);
+            auto c = static_cast<double>(cosl(angle));
+            auto s = static_cast<double>(sinl(angle));
+            out[j] = {c, s};
+            if (quarter > 0) {
+                out[quarter - j] = {s, c};
+                out[quarter + j] = {-s, c};
             }
-            j += bit;
-            if (i < j) {
-                swap(digits[i], digits[j]);
+            if (j > 0) {
+                out[n / 2 - j] = {-c, s};
             }
         }
+    }
 
-        for (size_t len = 2; len <= digits.size(); len *= 2) {
-            long double ang = 2 * pi / static_cast<long double>(len);
-            if (invert)
-                ang = -ang;
-            std::complex<long double> w_len(cosl(ang), sinl(ang));
-            for (size_t i = 0; i < digits.size(); i += len) {
-                std::complex<long double> w(1);
+    // roots[len / 2 + j] = exp(2 pi i j / len) for every power of two len <= roots.size().
+    const std::vector<Complex>& fftRoots(size_t n) {
+        thread_local std::vector<Complex> roots;
+        if (roots.size() < n) {
+            roots.assign(n, 0);
+            fillRoots(roots.data() + n / 2, n);
+            for (size_t len = n / 2; len >= 2; len /= 2) {
                 for (size_t j = 0; j < len / 2; ++j) {
-                    std::complex<long double> u = digits[i + j];
-                    std::complex<long double> v = digits[i + j + len / 2] * w;
-                    digits[i + j] = u + v;
-                    digits[i + j + len / 2] = u - v;
-                    w *= w_len;
+                    roots[len / 2 + j] = roots[len + 2 * j];
                 }
             }
         }
-        if (invert) {
-            long double n = digits.size();
-            for (auto& digit : digits) {
-                digit /= n;
+        return roots;
+    }
+
+    // exp(2 pi i j / n) = roots[j * stride] for j < n, where n is three times a power of two.
+    const std::vector<Complex>& mixedRoots(size_t n, size_t& stride) {
+        thread_local std::vector<Complex> roots;
+        if (roots.size() < n) {
+            roots.assign(n, 0);
+            fillRoots(roots.data(), n);
+            for (size_t j = n / 2; j < n; ++j) {
+                roots[j] = -roots[j - n / 2];
+            }
+        }
+        stride = roots.size() / n;
+        return roots;
+    }
+
+    // Radix-3 decimation-in-frequency pass splitting x[0, 3 * block) into three twiddled blocks; frequency 3m + t
+    // ends up in block t.
+    void forwardTriple(Complex* x, size_t block) {
+        size_t stride = 0;
+        const Complex* w = mixedRoots(3 * block, stride).data();
+        const double half_sqrt3 = std::sqrt(3.0) / 2;
+        for (size_t j = 0; j < block; ++j) {
+            Complex a0 = x[j], a1 = x[j + block], a2 = x[j + 2 * block];
+            Complex sum = a1 + a2;
+            Complex difference = (a1 - a2) * half_sqrt3;
+            Complex middle = a0 - sum * 0.5;
+            Complex rotated = {-difference.imag(), difference.real()};
+            x[j] = a0 + sum;
+            x[j + block] = times(middle + rotated, w[j * stride]);
+            x[j + 2 * block] = times(middle - rotated, w[2 * j * stride]);
+        }
+    }
+
+    // Inverse of forwardTriple up to a factor of 3.
+    void inverseTriple(Complex* x, size_t block) {
+        size_t stride = 0;
+        const Complex* w = mixedRoots(3 * block, stride).data();
+        const double half_sqrt3 = std::sqrt(3.0) / 2;
+        for (size_t j = 0; j < block; ++j) {
+            Complex a0 = x[j];
+            Complex a1 = times(x[j + block], conj(w[j * stride]));
+            Complex a2 = times(x[j + 2 * block], conj(w[2 * j * stride]));
+            Complex sum = a1 + a2;
+            Complex difference = (a1 - a2) * half_sqrt3;
+            Complex middle = a0 - sum * 0.5;
+            Complex rotated = {-difference.imag(), difference.real()};
+            x[j] = a0 + sum;
+            x[j + block] = middle - rotated;
+            x[j + 2 * block] = middle + rotated;
+        }
+    }
+
+    // Two fused radix-2 decimation-in-frequency levels over x[0, len); twiddles are explicit real / imaginary
+    // arithmetic, so the loop vectorizes without the library complex multiply.
+    void forwardPass(Complex* x, size_t len, const Complex* roots) {
+        size_t quarter = len / 4;
+        const Complex* w1 = roots + len / 2;
+        const Complex* w2 = roots + len / 4;
+        for (size_t j = 0; j < quarter; ++j) {
+            double w1r = w1[j].real(), w1i = w1[j].imag();
+            double w2r = w2[j].real(), w2i = w2[j].imag();
+            double w3r = w1r * w2r - w1i * w2i, w3i = w1r * w2i + w1i * w2r;
+            Complex a0 = x[j], a1 = x[j + quarter], a2 = x[j + 2 * quarter], a3 = x[j + 3 * quarter];
+            double sr = a0.real() + a2.real(), si = a0.imag() + a2.imag();
+            double tr = a1.real() + a3.real(), ti = a1.imag() + a3.imag();
+            double dr = a0.real() - a2.real(), di = a0.imag() - a2.imag();
+            double er = a3.imag() - a1.imag(), ei = a1.real() - a3.real();
+            double c1r = sr - tr, c1i = si - ti;
+            double c2r = dr + er, c2i = di + ei;
+            double c3r = dr - er, c3i = di - ei;
+            x[j] = {sr + tr, si + ti};
+            x[j + quarter] = {c1r * w2r - c1i * w2i, c1r * w2i + c1i * w2r};
+            x[j + 2 * quarter] = {c2r * w1r - c2i * w1i, c2r * w1i + c2i * w1r};
+            x[j + 3 * quarter] = {c3r * w3r - c3i * w3i, c3r * w3i + c3i * w3r};
+        }
+    }
+
+    // Inverse of forwardPass up to a factor of 4: two fused decimation-in-time levels with conjugate twiddles.
+    void inversePass(Complex* x, size_t len, const Complex* roots) {
+        size_t quarter = len / 4;
+        const Complex* w1 = roots + len / 2;
+        const Complex* w2 = roots + len / 4;
+        for (size_t j = 0; j < quarter; ++j) {
+            double w1r = w1[j].real(), w1i = -w1[j].imag();
+            double w2r = w2[j].real(), w2i = -w2[j].imag();
+            double w3r = w1r * w2r - w1i * w2i, w3i = w1r * w2i + w1i * w2r;
+            Complex a0 = x[j], a1 = x[j + quarter], a2 = x[j + 2 * quarter], a3 = x[j + 3 * quarter];
+            double br = a1.real() * w2r - a1.imag() * w2i, bi = a1.real() * w2i + a1.imag() * w2r;
+            double qr = a2.real() * w1r - a2.imag() * w1i, qi = a2.real() * w1i + a2.imag() * w1r;
+            double rr = a3.real() * w3r - a3.imag() * w3i, ri = a3.real() * w3i + a3.imag() * w3r;
+            double sr = a0.real() + br, si = a0.imag() + bi;
+            double dr = a0.real() - br, di = a0.imag() - bi;
+            double tr = qr + rr, ti = qi + ri;
+            double er = qi - ri, ei = rr - qr;
+            x[j] = {sr + tr, si + ti};
+            x[j + quarter] = {dr + er, di + ei};
+            x[j + 2 * quarter] = {sr - tr, si - ti};
+            x[j + 3 * quarter] = {dr - er, di - ei};
+        }
+    }
+
+    void pairPass(Complex* x, size_t n) {
+        for (size_t i = 0; i < n; i += 2) {
+            Complex u = x[i];
+            x[i] += x[i + 1];
+            x[i + 1] = u - x[i + 1];
+        }
+    }
+
+    // Natural order in, bit-reversed order out.
+    void forwardTransform(Complex* x, size_t n, const Complex* roots) {
+        if (n > FFT_CACHE_BLOCK) {
+            forwardPass(x, n, roots);
+            for (size_t i = 0; i < n; i += n / 4) {
+                forwardTransform(x + i, n / 4, roots);
             }
+            return;
+        }
+        size_t len = n;
+        for (; len >= 4; len /= 4) {
+            for (size_t i = 0; i < n; i += len) {
+                forwardPass(x + i, len, roots);
+            }
+        }
+        if (len == 2) {
+            pairPass(x, n);
+        }
+    }
+
+    // Bit-reversed order in, natural order out, scaled by n.
+    void inverseTransform(Complex* x, size_t n, const Complex* roots) {
+        if (n > FFT_CACHE_BLOCK) {
+            for (size_t i = 0; i < n; i += n / 4) {
+                inverseTransform(x + i, n / 4, roots);
+            }
+            inversePass(x, n, roots);
+            return;
+        }
+        size_t len = 4;
+        if (std::countr_zero(n) % 2 == 1) {
+            pairPass(x, n);
+            len = 8;
+        }
+        for (; len <= n; len *= 4) {
+            for (size_t i = 0; i < n; i += len) {
+                inversePass(x + i, len, roots);
+            }
+        }
+    }
+
+    // Power-of-two part of a transform length: the whole length, or a third of it.
+    size_t fftBlock(size_t n) {
+        return std::has_single_bit(n) ? n : n / 3;
+    }
+
+    // The forward transform leaves each power-of-two block of the spectrum in bit-reversed order and the inverse
+    // expects it that way, so no reordering pass is needed between them.
+    void fft(std::vector<Complex>& digits, bool invert) {
+        size_t block = fftBlock(digits.size());
+        const std::vector<Complex>& roots = fftRoots(block);
+        if (!invert) {
+            if (block != digits.size()) {
+                forwardTriple(digits.data(), block);
+            }
+            for (size_t i = 0; i < digits.size(); i += block) {
+                forwardTransform(digits.data() + i, block, roots.data());
+            }
+            return;
+        }
+        for (size_t i = 0; i < digits.size(); i += block) {
+            inverseTransform(digits.data() + i, block, roots.data());
+        }
+        if (block != digits.size()) {
+            inverseTriple(digits.data(), block);
+        }
+        double n = static_cast<double>(digits.size());
+        for (auto& digit : digits) {
+            digit /= n;
         }
     }
 }
+#endif
+
+#ifdef BIGINTEGER_SHARED_LIMBS
+
+// Copy-on-write limb storage: copies share one buffer until either side is modified. Every non-const member,
+// including operator[], back(), begin() and the conversion to Buffer&, counts as a write and detaches a shared
+// buffer first, so code that only reads should go through a const reference (std::as_const or a const Buffer&).
+class SharedLimbs {
+private:
+    using Buffer = std::vector<long long>;
+
+    std::shared_ptr<Buffer> buffer;
+
+    const Buffer& view() const {
+        static const Buffer empty;
+        return buffer ? *buffer : empty;
+    }
+
+    Buffer& own() {
+        if (!buffer) {
+            buffer = std::make_shared<Buffer>();
+        } else if (buffer.use_count() > 1) {
+            buffer = std::make_shared<Buffer>(*buffer);
+        } else {
+            std::atomic_thread_fence(std::memory_order_acquire);
+        }
+        return *buffer;
+    }
+
+public:
+    using value_type = long long;
+    using size_type = size_t;
+    using iterator = Buffer::iterator;
+    using const_iterator = Buffer::const_iterator;
+
+    SharedLimbs() = default;
+    SharedLimbs(Buffer values) : buffer(std::make_shared<Buffer>(std::move(values))) {}
+    SharedLimbs(std::initializer_list<long long> values) : buffer(std::make_shared<Buffer>(values)) {}
+    explicit SharedLimbs(size_t count, long long value = 0) : buffer(std::make_shared<Buffer>(count, value)) {}
+
+    operator const Buffer&() const {
+        return view();
+    }
+    operator Buffer&() {
+        return own();
+    }
+
+    bool shared() const {
+        return buffer.use_count() > 1;
+    }
+
+    size_t size() const {
+        return view().size();
+    }
+    bool empty() const {
+        return view().empty();
+    }
+    size_t capacity() const {
+        return view().capacity();
+    }
+
+    const long long& operator[](size_t i) const {
+        return view()[i];
+    }
+    long long& operator[](size_t i) {
+        return own()[i];
+    }
+    const long long& back() const {
+        return view().back();
+    }
+    long long& back() {
+        return own().back();
+    }
+
+    const_iterator begin() const {
+        return view().begin();
+    }
+    const_iterator end() const {
+        return view().end();
+    }
+    iterator begin() {
+        return own().begin();
+    }
+    iterator end() {
+        return own().end();
+    }
+
+    void push_back(long long value) {
+        own().push_back(value);
+    }
+    void pop_back() {
+        own().pop_back();
+    }
+    // Positions may point into the shared buffer, so they are carried over to the detached copy by offset.
+    iterator insert(const_iterator position, size_t count, long long value) {
+        auto offset = position - view().begin();
+        Buffer& values = own();
+        return values.insert(values.begin() + offset, count, value);
+    }
+    iterator erase(const_iterator first, const_iterator last) {
+        auto from = first - view().begin();
+        auto to = last - view().begin();
+        Buffer& values = own();
+        return values.erase(values.begin() + from, values.begin() + to);
+    }
+    void assign(size_t count, long long value) {
+        if (shared()) {
+            buffer = std::make_shared<Buffer>(count, value);
+        } else {
+            own().assign(count, value);
+        }
+    }
+    void resize(size_t count, long long value = 0) {
+        own().resize(count, value);
+    }
+    void reserve(size_t count) {
+        own().reserve(count);
+    }
+    void clear() {
+        own().clear();
+    }
+
+    bool operator==(const SharedLimbs& x) const {
+        return buffer == x.buffer || view() == x.view();
+    }
+};
+#endif
 
 class BigInteger;
 BigInteger multiply(BigInteger, long long);
 
+namespace bigint_expr {
+    template <typename T>
+    concept Expression = requires { typename T::is_expression; };
+
+    template <typename Left, typename Right>
+    struct Product;
+}
+
 class BigInteger {
 private:
+    template <size_t>
+    friend class FixedBigInt;
+    template <typename, typename>
+    friend struct bigint_expr::Product;
+    friend struct Kronecker;
+    friend class ModularBasis;
+    friend class Rational;
+    friend class ContinuedFraction;
+    friend class BigFloat;
+    friend class PreparedMultiplier;
+    friend class Divisor;
 
     static const long long REAL_BASE = 1e3;
     static const long long USER_BASE = 10;
+    static const uint64_t WORD_BASE = 1000000000;
+    static const uint64_t HASH_MULTIPLIER = 0x9e3779b97f4a7c15;
+    static constexpr size_t HASH_LANES = 4;
     static const size_t DIGIT_SIZE = 3;
+    // BIGINTEGER_FFT_ERROR_LIMIT lowers the bound on a transform's rounding error, so that ordinary operands take the
+    // split-limb transform and the schoolbook fallback that otherwise need millions of digits or more memory than
+    // exists.
+#ifdef BIGINTEGER_FFT_ERROR_LIMIT
+    static constexpr double FFT_ERROR_LIMIT = BIGINTEGER_FFT_ERROR_LIMIT;
+#else
+    static constexpr double FFT_ERROR_LIMIT = 0.25;
+#endif
+    static constexpr double FFT_ROOT_ERROR = 3;
+    static const long long FFT_SPLIT_BASE = 32;
+    static const size_t HENSEL_SCHOOLBOOK_LIMBS = 1024;
+    static const size_t FFT_SCHOOLBOOK_LIMBS = 32;
+    static const size_t FFT_UNBALANCED_RATIO = 8;
+    static const size_t FFT_CHUNK_FACTOR = 4;
+    static const size_t RADIX_THRESHOLD = 1024;
+    static const size_t RADIX_SPLIT_THRESHOLD = 1 << 16;
+    static const size_t RADIX_SPLIT_BITS = 16384;
+    static constexpr size_t POWER_STEP = 16;
+    static constexpr unsigned long long SMALL_FACTOR_LIMIT = 1ULL << 40;
+    static constexpr unsigned long long DOT_HEADROOM = 1ULL << 62;
+    static constexpr const char* RADIX_DIGITS = "0123456789abcdefghijklmnopqrstuvwxyz";
+
+    static int digitValue(char c) {
+        if ('0' <= c && c <= '9') {
+            return c - '0';
+        }
+        if ('a' <= c && c <= 'z') {
+            return c - 'a' + 10;
+        }
+        if ('A' <= c && c <= 'Z') {
+            return c - 'A' + 10;
+        }
+        return 36;
+    }
+
+    static void checkRadix(int base) {
+        if (base < 2 || base > 36) {
+            throw std::invalid_argument("BigInteger: base must be between 2 and 36");
+        }
+    }
+
+    static uint64_t hashMix(uint64_t h) {
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccd;
+        h ^= h >> 33;
+        h *= 0xc4ceb9fe1a85ec53;
+        h ^= h >> 33;
+        return h;
+    }
+
+    template <typename Word>
+    static uint64_t hashWords(const Word* words, size_t count, bool negative, uint64_t seed) {
+        std::array<uint64_t, HASH_LANES> lanes{};
+        for (size_t k = 0; k < HASH_LANES; ++k) {
+            lanes[k] = seed + k * HASH_MULTIPLIER;
+        }
+        size_t i = 0;
+        for (; i + HASH_LANES <= count; i += HASH_LANES) {
+            for (size_t k = 0; k < HASH_LANES; ++k) {
+                lanes[k] = (lanes[k] ^ static_cast<uint64_t>(words[i + k])) * HASH_MULTIPLIER;
+            }
+        }
+        uint64_t h = (seed ^ (count << 1 | static_cast<uint64_t>(negative))) * HASH_MULTIPLIER;
+        for (; i < count; ++i) {
+            h = (h ^ static_cast<uint64_t>(words[i])) * HASH_MULTIPLIER;
+        }
+        for (uint64_t lane : lanes) {
+            h = hashMix(h ^ lane);
+        }
+        return h;
+    }
+
+    template <typename Builder, typename Next>
+    static bool readDigits(Builder& builder, int base, int c, Next next) {
+        while (c != std::char_traits<char>::eof() && digitValue(static_cast<char>(c)) < base) {
+            builder.push(digitValue(static_cast<char>(c)));
+            c = next();
+        }
+        return c == std::char_traits<char>::eof();
+    }
+
+#ifndef BIGINTEGER_USE_GMP
+#ifdef BIGINTEGER_SHARED_LIMBS
+    using Limbs = SharedLimbs;
+#else
+    using Limbs = std::vector<long long>;
+#endif
 
-    std::vector<long long> digits;
+    Limbs digits;
     bool is_negative;
 
     void deleteZeroes() {
@@ -73,466 +661,4952 @@ private:
         }
     }
 
-    void toCarry() {
-        long long carry = 0;
-        for (auto& digit : digits) {
-            digit += carry;
-            carry = digit / REAL_BASE;
-            digit %= REAL_BASE;
+    class DecimalBuilder {
+    public:
+        explicit DecimalBuilder(BigInteger& target) : target(target) {
+            target.digits.clear();
+        }
+
+        void push(int digit) {
+            seen = true;
+            if (digit == 0 && group_size == 0 && target.digits.empty()) {
+                return;
+            }
+            group = group * USER_BASE + digit;
+            if (++group_size == DIGIT_SIZE) {
+                target.digits.push_back(group);
+                group = 0;
+                group_size = 0;
+            }
         }
-        if (carry) {
-            digits.push_back(carry);
+
+        bool finish(bool negative) {
+            std::vector<long long>& limbs = target.digits;
+            if (group_size != 0) {
+                long long low = 1;
+                for (size_t i = group_size; i < DIGIT_SIZE; ++i) {
+                    low *= USER_BASE;
+                }
+                long long high = REAL_BASE / low;
+                size_t k = limbs.size();
+                limbs.push_back(group);
+                if (k != 0) {
+                    limbs[k] = limbs[k - 1] % low * high + group;
+                    for (size_t i = k - 1; i > 0; --i) {
+                        limbs[i] = limbs[i - 1] % low * high + limbs[i] / low;
+                    }
+                    limbs[0] /= low;
+                }
+            }
+            reverse(limbs.begin(), limbs.end());
+            if (limbs.empty()) {
+                limbs.push_back(0);
+            }
+            target.is_negative = negative;
+            target.deleteZeroes();
+            return seen;
+        }
+
+    private:
+        BigInteger& target;
+        long long group = 0;
+        size_t group_size = 0;
+        bool seen = false;
+    };
+
+    static long long pow5Small(size_t exponent) {
+        long long result = 1;
+        while (exponent--) {
+            result *= 5;
         }
+        return result;
     }
 
-public:
+    static std::pair<size_t, long long> radixChunk(int base) {
+        const long long limit = 1LL << 40;
+        size_t size = 1;
+        long long power = base;
+        while (power <= limit / base) {
+            power *= base;
+            ++size;
+        }
+        return {size, power};
+    }
 
-    void multiply(long long x) {
-        is_negative = false;
+    void multiplyAdd(long long factor, long long addend) {
+        long long carry = addend;
         for (auto& digit : digits) {
-            digit *= x;
+            long long cur = digit * factor + carry;
+            digit = cur % REAL_BASE;
+            carry = cur / REAL_BASE;
+        }
+        while (carry) {
+            digits.push_back(carry % REAL_BASE);
+            carry /= REAL_BASE;
         }
-        toCarry();
-        deleteZeroes();
     }
 
-    BigInteger(): digits(1), is_negative(false) {}
-    BigInteger(long long x) : is_negative(x < 0) {
-        if (x == 0) {
-            digits.resize(1);
-            return;
+    std::to_chars_result toDecimalChars(char* first, char* last) const {
+        char* ptr = first;
+        long long top = digits.back();
+        char head[DIGIT_SIZE];
+        size_t head_size = 0;
+        do {
+            head[head_size++] = static_cast<char>('0' + top % USER_BASE);
+            top /= USER_BASE;
+        } while (top);
+        if (static_cast<size_t>(last - ptr) < head_size + DIGIT_SIZE * (digits.size() - 1)) {
+            return {last, std::errc::value_too_large};
         }
-        if (is_negative) {
-            x = -x;
+        while (head_size) {
+            *ptr++ = head[--head_size];
         }
-        while (x) {
-            digits.push_back(x % REAL_BASE);
-            x /= REAL_BASE;
+        for (size_t i = digits.size() - 1; i-- > 0;) {
+            long long t = digits[i];
+            for (size_t j = DIGIT_SIZE; j-- > 0;) {
+                ptr[j] = static_cast<char>('0' + t % USER_BASE);
+                t /= USER_BASE;
+            }
+            ptr += DIGIT_SIZE;
         }
+        return {ptr, std::errc()};
     }
 
-    void swap(BigInteger& x) {
-        std::swap(digits, x.digits);
-        std::swap(is_negative, x.is_negative);
-    }
+    char* radixDigitsReversed(char* ptr, char* last, int base, size_t width) const {
+        static thread_local std::vector<long long> scratch;
+        scratch.assign(digits.begin(), digits.end());
+        auto [chunk_size, chunk_base] = radixChunk(base);
+        bool pow2 = std::has_single_bit(static_cast<unsigned>(base));
+        int shift = std::countr_zero(static_cast<unsigned long long>(chunk_base));
+        long long mask = chunk_base - 1;
 
-    explicit operator bool() const {
-        return digits.size() != 1 || digits[0] != 0;
+        char* begin = ptr;
+        size_t top = scratch.size();
+        while (top > 1 || scratch[0] != 0) {
+            long long rem = 0;
+            for (size_t i = top; i-- > 0;) {
+                long long cur = rem * REAL_BASE + scratch[i];
+                if (pow2) {
+                    scratch[i] = cur >> shift;
+                    rem = cur & mask;
+                } else {
+                    scratch[i] = cur / chunk_base;
+                    rem = cur % chunk_base;
+                }
+            }
+            while (top > 1 && scratch[top - 1] == 0) {
+                --top;
+            }
+            bool last_chunk = top == 1 && scratch[0] == 0;
+            for (size_t j = 0; j < chunk_size && (rem || !last_chunk); ++j) {
+                if (ptr == last) {
+                    return nullptr;
+                }
+                *ptr++ = RADIX_DIGITS[rem % base];
+                rem /= base;
+            }
+        }
+        while (static_cast<size_t>(ptr - begin) < width) {
+            if (ptr == last) {
+                return nullptr;
+            }
+            *ptr++ = '0';
+        }
+        return ptr;
     }
 
-    void applyAbs() {
-        is_negative = false;
-    }
-    void changeSign() {
-        if (*this) {
-            is_negative = !is_negative;
+    void dropLimbs(size_t count) {
+        if (count >= digits.size()) {
+            digits.assign(1, 0);
+        } else {
+            digits.erase(digits.begin(), digits.begin() + static_cast<std::ptrdiff_t>(count));
         }
+        deleteZeroes();
     }
 
+    std::vector<uint64_t> wordsReversed() const {
+        std::vector<uint64_t> words((digits.size() + 2) / 3);
+        for (size_t i = 0; i < digits.size(); ++i) {
+            uint64_t scale = i % 3 == 0 ? 1 : i % 3 == 1 ? 1000 : 1000000;
+            words[words.size() - 1 - i / 3] += static_cast<uint64_t>(digits[i]) * scale;
+        }
+        return words;
+    }
 
-    BigInteger operator+() const {
-        return *this;
+    char* pow2DigitsReversed(char* ptr, char* last, int base, size_t width, size_t level,
+                             const std::vector<BigInteger>& pow2, const std::vector<BigInteger>& pow5,
+                             const std::vector<size_t>& split) const {
+        if (level == 0 || digits.size() <= RADIX_THRESHOLD) {
+            return radixDigitsReversed(ptr, last, base, width);
+        }
+        --level;
+        if (width == 0 && *this < pow2[level]) {
+            return pow2DigitsReversed(ptr, last, base, 0, level, pow2, pow5, split);
+        }
+        size_t bits = split[level] * static_cast<size_t>(std::countr_zero(static_cast<unsigned>(base)));
+        BigInteger high = *this;
+        high *= pow5[level];
+        high.dropLimbs(bits / DIGIT_SIZE);
+        BigInteger low = high;
+        low *= pow2[level];
+        low.changeSign();
+        low += *this;
+        ptr = low.pow2DigitsReversed(ptr, last, base, split[level], level, pow2, pow5, split);
+        if (!ptr) {
+            return nullptr;
+        }
+        return high.pow2DigitsReversed(ptr, last, base, width > split[level] ? width - split[level] : 0,
+                                       level, pow2, pow5, split);
     }
-    BigInteger operator-() const {
-        BigInteger copy = *this;
-        copy.changeSign();
-        return copy;
+
+    std::to_chars_result toRadixChars(char* first, char* last, int base) const {
+        char* end = nullptr;
+        if (std::has_single_bit(static_cast<unsigned>(base)) && digits.size() > RADIX_SPLIT_THRESHOLD) {
+            BigInteger magnitude = *this;
+            magnitude.applyAbs();
+            size_t bits_per_digit = static_cast<size_t>(std::countr_zero(static_cast<unsigned>(base)));
+            size_t digit_count = DIGIT_SIZE * ((RADIX_SPLIT_BITS / bits_per_digit + DIGIT_SIZE - 1) / DIGIT_SIZE);
+            std::vector<BigInteger> pow2(1, 1);
+            std::vector<BigInteger> pow5(1, 1);
+            std::vector<size_t> split(1, digit_count);
+            for (size_t done = 0; done < bits_per_digit * digit_count; done += POWER_STEP) {
+                size_t step = std::min(POWER_STEP, bits_per_digit * digit_count - done);
+                pow2[0].multiply(1LL << step);
+                pow5[0].multiply(pow5Small(step));
+            }
+            while (pow2.back() <= magnitude) {
+                pow2.push_back(pow2.back());
+                pow2.back() *= pow2.back();
+                pow5.push_back(pow5.back());
+                pow5.back() *= pow5.back();
+                split.push_back(2 * split.back());
+            }
+            end = magnitude.pow2DigitsReversed(first, last, base, 0, pow2.size() - 1, pow2, pow5, split);
+        } else {
+            end = radixDigitsReversed(first, last, base, 0);
+        }
+        if (end == first && end != last) {
+            *end++ = '0';
+        }
+        if (end == nullptr || end == first) {
+            return {last, std::errc::value_too_large};
+        }
+        std::reverse(first, end);
+        return {end, std::errc()};
     }
 
-    BigInteger& operator+=(const BigInteger& x) {
-        if (x.is_negative == is_negative) {
-            if (x.digits.size() > digits.size()) {
-                digits.resize(x.digits.size());
+    class RadixBuilder {
+    public:
+        RadixBuilder(BigInteger& target, int base)
+            : target(target)
+            , base(base)
+            , chunk_base(radixChunk(base).second) {}
+
+        void push(int digit) {
+            seen = true;
+            chunk = chunk * base + digit;
+            power *= base;
+            if (power == chunk_base) {
+                chunks.push_back(chunk);
+                chunk = 0;
+                power = 1;
             }
-            long long carry = 0;
-            for (size_t i = 0; i < x.digits.size(); ++i) {
-                digits[i] += x.digits[i] + carry;
-                carry = digits[i] >= REAL_BASE;
-                if (carry) {
-                    digits[i] -= REAL_BASE;
-                }
+        }
+
+        bool finish(bool negative) {
+            target = combine(0, chunks.size());
+            if (power != 1) {
+                target.multiplyAdd(power, chunk);
             }
+            target.is_negative = negative;
+            target.deleteZeroes();
+            return seen;
+        }
 
-            if (carry) {
-                size_t i = x.digits.size();
-                while (i < digits.size() && digits[i] + 1 == REAL_BASE) {
-                    digits[i] = 0;
-                    ++i;
+    private:
+        BigInteger& target;
+        int base;
+        long long chunk_base;
+        std::vector<long long> chunks;
+        std::vector<BigInteger> powers;
+        long long chunk = 0;
+        long long power = 1;
+        bool seen = false;
+
+        BigInteger combine(size_t first, size_t last) {
+            BigInteger result;
+            if (last - first <= RADIX_THRESHOLD) {
+                for (size_t i = first; i < last; ++i) {
+                    result.multiplyAdd(chunk_base, chunks[i]);
+                }
+                return result;
+            }
+            size_t level = std::numeric_limits<size_t>::digits - 1 - static_cast<size_t>(std::countl_zero(last - first - 1));
+            size_t middle = last - (size_t(1) << level);
+            if (powers.empty()) {
+                powers.emplace_back(chunk_base);
+            }
+            while (powers.size() <= level) {
+                powers.push_back(powers.back());
+                powers.back() *= powers.back();
+            }
+            result = combine(first, middle);
+            result *= powers[level];
+            result += combine(middle, last);
+            return result;
+        }
+    };
+
+    void toCarry() {
+        long long carry = 0;
+        for (auto& digit : digits) {
+            digit += carry;
+            carry = digit / REAL_BASE;
+            digit %= REAL_BASE;
+        }
+        while (carry) {
+            digits.push_back(carry % REAL_BASE);
+            carry /= REAL_BASE;
+        }
+    }
+
+    // Percival's bound on the absolute error of an FFT convolution of length n with correctly rounded roots.
+    static double fftErrorBound(size_t n, double norm_a, double norm_b) {
+        const double unit = std::numeric_limits<double>::epsilon() / 2;
+        auto levels = static_cast<double>(std::bit_width(n - 1));
+        return norm_a * norm_b * unit * (3 * levels * (1 + FFT_ROOT_ERROR) + (3 * levels + 1) * std::sqrt(5.0));
+    }
+
+    static long long limbPiece(long long limb, int piece) {
+        return piece == 0 ? limb : piece > 0 ? limb / FFT_SPLIT_BASE : limb % FFT_SPLIT_BASE;
+    }
+
+    // Transforms re + i * im (whole limbs, or their quotients / remainders by FFT_SPLIT_BASE) in one n-point FFT.
+    static std::vector<Complex> packedSpectrum(const std::vector<long long>& re, const std::vector<long long>& im,
+                                               size_t n, int piece, double& norm) {
+        std::vector<Complex> f(n);
+        double squares = 0;
+        for (size_t i = 0; i < re.size(); ++i) {
+            auto value = static_cast<double>(limbPiece(re[i], piece));
+            f[i].real(value);
+            squares += value * value;
+        }
+        for (size_t i = 0; i < im.size(); ++i) {
+            auto value = static_cast<double>(limbPiece(im[i], -piece));
+            f[i].imag(value);
+            squares += value * value;
+        }
+        norm = std::sqrt(squares);
+        fft(f, false);
+        return f;
+    }
+
+    // Position of the negated frequency in a spectrum stored as bit-reversed blocks. Within the first block it is
+    // k mirrored inside its octave [bit_floor(k), 2 * bit_floor(k)); blocks 1 and 2 of a radix-3 split hold each
+    // other's negations in reverse order.
+    static size_t mirrorPosition(size_t k, size_t block) {
+        if (k >= block) {
+            return 4 * block - 1 - k;
+        }
+        return k == 0 ? 0 : k ^ (std::bit_floor(k) - 1);
+    }
+
+    // Splits the spectrum of re + i * im into the spectra of re and im at position k.
+    static std::pair<Complex, Complex> unpackSpectrum(const std::vector<Complex>& f, size_t block, size_t k) {
+        Complex mirror = conj(f[mirrorPosition(k, block)]);
+        Complex difference = (f[k] - mirror) * 0.5;
+        return {(f[k] + mirror) * 0.5, {difference.imag(), -difference.real()}};
+    }
+
+    // Spectrum of the real sequence x at length n, from a half-length FFT of x[2j] + i * x[2j + 1]; the inverse
+    // of collectReal's folding.
+    static std::vector<Complex> realSpectrum(const std::vector<long long>& x, size_t n, double& norm) {
+        std::vector<Complex> z(n / 2);
+        double squares = 0;
+        for (size_t i = 0; i < x.size(); ++i) {
+            auto value = static_cast<double>(x[i]);
+            if (i % 2 == 0) {
+                z[i / 2].real(value);
+            } else {
+                z[i / 2].imag(value);
+            }
+            squares += value * value;
+        }
+        norm = std::sqrt(squares);
+        fft(z, false);
+
+        size_t block = fftBlock(n);
+        size_t blocks = n / block;
+        size_t half = block / 2;
+        size_t stride = 1;
+        const Complex* roots = blocks == 1 ? fftRoots(n).data() + n / 2 : mixedRoots(n, stride).data();
+        std::vector<Complex> f(n);
+        for (size_t p = 0, m = 0; p < half; ++p) {
+            for (size_t t = 0; t < blocks; ++t) {
+                auto [even, odd] = unpackSpectrum(z, half, t * half + p);
+                Complex twisted = times(odd, roots[(blocks * m + t) * stride]);
+                f[t * block + 2 * p] = even + twisted;
+                f[t * block + 2 * p + 1] = even - twisted;
+            }
+            size_t bit = half >> 1;
+            for (; m & bit; bit >>= 1) {
+                m ^= bit;
+            }
+            m |= bit;
+        }
+        return f;
+    }
+
+    // Inverts the spectrum of a real sequence with a half-length FFT and adds scale * round(x[i]) to product[i];
+    // false if any value was not near an integer. Within block t, frequencies k and k + n / 2 sit side by side at
+    // 2p and 2p + 1, and the half-length spectrum is built directly in the same blocked bit-reversed order.
+    static bool collectReal(const std::vector<Complex>& f, std::vector<long long>& product, long long scale) {
+        size_t n = f.size();
+        size_t block = fftBlock(n);
+        size_t blocks = n / block;
+        size_t half = block / 2;
+        size_t stride = 1;
+        const Complex* roots = blocks == 1 ? fftRoots(n).data() + n / 2 : mixedRoots(n, stride).data();
+        std::vector<Complex> packed(n / 2);
+        for (size_t p = 0, m = 0; p < half; ++p) {
+            for (size_t t = 0; t < blocks; ++t) {
+                const Complex* pair = f.data() + t * block + 2 * p;
+                Complex even = (pair[0] + pair[1]) * 0.5;
+                Complex odd = times((pair[0] - pair[1]) * 0.5, conj(roots[(blocks * m + t) * stride]));
+                packed[t * half + p] = even + Complex(-odd.imag(), odd.real());
+            }
+            size_t bit = half >> 1;
+            for (; m & bit; bit >>= 1) {
+                m ^= bit;
+            }
+            m |= bit;
+        }
+        fft(packed, true);
+        return addRounded(reinterpret_cast<const double*>(packed.data()), 1, product.size(), product, 0, scale);
+    }
+
+    // Adds scale * round(values[i * step]) to product[offset + i] for i < count; false if any value was not near
+    // an integer. Adding and subtracting 1.5 * 2^52 rounds to the nearest integer without a library call.
+    static bool addRounded(const double* values, size_t step, size_t count, std::vector<long long>& product,
+                           size_t offset, long long scale) {
+        const double shift = 6755399441055744.0;
+        double distance = 0;
+        for (size_t i = 0; i < count; ++i) {
+            double value = values[i * step];
+            double rounded = (value + shift) - shift;
+            distance = std::max(distance, std::abs(value - rounded));
+            product[offset + i] += scale * static_cast<long long>(rounded);
+        }
+        return distance < FFT_ERROR_LIMIT;
+    }
+
+    // Multiplies a long operand by a much shorter one: the longer side is cut into chunks that, convolved with
+    // the shorter, fit a transform a few times the shorter's length. The shorter operand is transformed once,
+    // and two chunks share every transform as real and imaginary parts, so each product comes out of one
+    // complex inverse with no unpacking.
+    static size_t chunkLength(size_t shorter) {
+        return fftLength(FFT_CHUNK_FACTOR * shorter);
+    }
+
+    static bool chunkedProduct(const std::vector<long long>& longer, size_t shorter, const std::vector<Complex>& spectrum,
+                               double norm_short, std::vector<long long>& product) {
+        size_t n = spectrum.size();
+        size_t chunk = n - shorter + 1;
+
+        std::vector<Complex> f(n);
+        for (size_t start = 0; start < longer.size(); start += 2 * chunk) {
+            size_t second = std::min(start + chunk, longer.size());
+            size_t end = std::min(second + chunk, longer.size());
+            double squares = 0;
+            for (size_t i = start; i < second; ++i) {
+                auto value = static_cast<double>(longer[i]);
+                f[i - start].real(value);
+                squares += value * value;
+            }
+            for (size_t i = second; i < end; ++i) {
+                auto value = static_cast<double>(longer[i]);
+                f[i - second].imag(value);
+                squares += value * value;
+            }
+            if (fftErrorBound(n, std::sqrt(squares), norm_short) >= FFT_ERROR_LIMIT) {
+                return false;
+            }
+            fft(f, false);
+            for (size_t k = 0; k < n; ++k) {
+                f[k] = times(f[k], spectrum[k]);
+            }
+            fft(f, true);
+
+            const double* values = reinterpret_cast<const double*>(f.data());
+            size_t tail = shorter - 1;
+            if (!addRounded(values, 2, second - start + tail, product, start, 1) ||
+                (end > second && !addRounded(values + 1, 2, end - second + tail, product, second, 1))) {
+                return false;
+            }
+            f.assign(n, 0);
+        }
+        return true;
+    }
+
+    static bool transformProduct(const std::vector<long long>& a, const std::vector<long long>& b,
+                                 std::vector<long long>& product) {
+        size_t n = fftLength(a.size() + b.size() - 1);
+        size_t block = fftBlock(n);
+        double norm = 0;
+        std::vector<Complex> f = packedSpectrum(a, b, n, 0, norm);
+        if (fftErrorBound(n, norm, norm) < FFT_ERROR_LIMIT) {
+            std::vector<Complex> spectrum(n);
+            for (size_t k = 0; k < n; ++k) {
+                auto [fa, fb] = unpackSpectrum(f, block, k);
+                spectrum[k] = times(fa, fb);
+            }
+            return collectReal(spectrum, product, 1);
+        }
+
+        double norm_a = 0;
+        double norm_b = 0;
+        std::vector<Complex> fa = packedSpectrum(a, a, n, 1, norm_a);
+        std::vector<Complex> fb = packedSpectrum(b, b, n, 1, norm_b);
+        if (2 * fftErrorBound(n, norm_a, norm_b) >= FFT_ERROR_LIMIT) {
+            return false;
+        }
+        std::vector<Complex> high(n);
+        std::vector<Complex> middle(n);
+        std::vector<Complex> low(n);
+        for (size_t k = 0; k < n; ++k) {
+            auto [ah, al] = unpackSpectrum(fa, block, k);
+            auto [bh, bl] = unpackSpectrum(fb, block, k);
+            high[k] = times(ah, bh);
+            middle[k] = times(ah, bl) + times(al, bh);
+            low[k] = times(al, bl);
+        }
+        return collectReal(high, product, FFT_SPLIT_BASE * FFT_SPLIT_BASE) &&
+               collectReal(middle, product, FFT_SPLIT_BASE) && collectReal(low, product, 1);
+    }
+
+    // Multiplies x by a real sequence whose length-n spectrum was computed in advance: one half-length forward
+    // and one half-length inverse transform.
+    static bool preparedProduct(const std::vector<long long>& x, const std::vector<Complex>& spectrum, double norm,
+                                std::vector<long long>& product) {
+        double norm_x = 0;
+        std::vector<Complex> f = realSpectrum(x, spectrum.size(), norm_x);
+        if (fftErrorBound(spectrum.size(), norm, norm_x) >= FFT_ERROR_LIMIT) {
+            return false;
+        }
+        for (size_t k = 0; k < f.size(); ++k) {
+            f[k] = times(f[k], spectrum[k]);
+        }
+        return collectReal(f, product, 1);
+    }
+
+    static void convolve(const std::vector<long long>& a, const std::vector<long long>& b,
+                         std::vector<long long>& out, long long sign, bool accumulate) {
+        size_t length = a.size() + b.size() - 1;
+        std::vector<long long> product(length);
+        const std::vector<long long>& longer = a.size() >= b.size() ? a : b;
+        const std::vector<long long>& shorter = a.size() >= b.size() ? b : a;
+        bool transformed = false;
+        if (shorter.size() > FFT_SCHOOLBOOK_LIMBS) {
+            if (longer.size() >= FFT_UNBALANCED_RATIO * shorter.size()) {
+                double norm = 0;
+                std::vector<Complex> spectrum = realSpectrum(shorter, chunkLength(shorter.size()), norm);
+                transformed = chunkedProduct(longer, shorter.size(), spectrum, norm, product);
+                if (!transformed) {
+                    product.assign(length, 0);
+                }
+            }
+            transformed = transformed || transformProduct(a, b, product);
+            if (!transformed) {
+                BIGINTEGER_NOTE_FFT_FALLBACK();
+                product.assign(length, 0);
+            }
+        }
+        if (!transformed) {
+            for (size_t j = 0; j < shorter.size(); ++j) {
+                for (size_t i = 0; i < longer.size(); ++i) {
+                    product[i + j] += longer[i] * shorter[j];
+                }
+            }
+        }
+
+        if (!accumulate) {
+            out.assign(length, 0);
+        } else if (out.size() < length) {
+            out.resize(length, 0);
+        }
+        for (size_t i = 0; i < length; ++i) {
+            out[i] += sign * product[i];
+        }
+    }
+
+    void normalizeSigned() {
+        long long carry = 0;
+        for (auto& digit : digits) {
+            digit += carry;
+            carry = digit / REAL_BASE;
+            digit %= REAL_BASE;
+            if (digit < 0) {
+                digit += REAL_BASE;
+                --carry;
+            }
+        }
+        while (carry > 0) {
+            digits.push_back(carry % REAL_BASE);
+            carry /= REAL_BASE;
+        }
+        if (carry < 0) {
+            for (auto& digit : digits) {
+                digit = -digit;
+            }
+            digits.push_back(-carry);
+            is_negative = !is_negative;
+            normalizeSigned();
+            return;
+        }
+        deleteZeroes();
+    }
+
+    void addProduct(const BigInteger& a, const BigInteger& b, bool subtract) {
+        bool negative = (a.is_negative != b.is_negative) != subtract;
+        convolve(a.digits, b.digits, digits, negative != is_negative ? -1 : 1, true);
+        normalizeSigned();
+    }
+
+    void addScaled(const BigInteger& a, unsigned long long factor, bool subtract) {
+        if (factor > SMALL_FACTOR_LIMIT) {
+            BigInteger wide;
+            wide.multiplyAdd(1, static_cast<long long>(factor >> 32));
+            wide.multiplyAdd(1LL << 32, static_cast<long long>(factor & 0xFFFFFFFFu));
+            addProduct(a, wide, subtract);
+            return;
+        }
+        long long sign = (a.is_negative != subtract) != is_negative ? -1 : 1;
+        long long scale = sign * static_cast<long long>(factor);
+        if (digits.size() < a.digits.size()) {
+            digits.resize(a.digits.size(), 0);
+        }
+        for (size_t i = 0; i < a.digits.size(); ++i) {
+            digits[i] += scale * a.digits[i];
+        }
+        normalizeSigned();
+    }
+
+    void keepLimbs(size_t count) {
+        if (count < digits.size()) {
+            digits.resize(count);
+        }
+        deleteZeroes();
+    }
+
+    void divideSmall(long long d) {
+        long long rest = 0;
+        for (size_t i = digits.size(); i-- > 0;) {
+            long long current = rest * REAL_BASE + digits[i];
+            digits[i] = current / d;
+            rest = current % d;
+        }
+        deleteZeroes();
+    }
+
+    // Exponent of the largest power of p = 2 or 5 dividing x, for x with a nonzero low limb. 1000^k is a multiple
+    // of p^(3k), so the low k limbs decide the exponent whenever it comes out below 3k; the window doubles until then.
+    static size_t valuation(const BigInteger& x, long long p) {
+        long long chunk = p;
+        size_t chunk_exponent = 1;
+        while (chunk <= (1LL << 30) / p) {
+            chunk *= p;
+            ++chunk_exponent;
+        }
+        for (size_t window = 1;; window *= 2) {
+            BigInteger low;
+            std::vector<long long>& limbs = low.digits;
+            limbs.assign(x.digits.begin(), x.digits.begin() + static_cast<std::ptrdiff_t>(std::min(window, x.digits.size())));
+            low.deleteZeroes();
+            size_t count = 0;
+            while (low.mod_small(chunk) == 0) {
+                low.divideSmall(chunk);
+                count += chunk_exponent;
+            }
+            while (low.mod_small(p) == 0) {
+                low.divideSmall(p);
+                ++count;
+            }
+            if (count < DIGIT_SIZE * window || window >= x.digits.size()) {
+                return count;
+            }
+        }
+    }
+
+    // Inverse modulo REAL_BASE of a limb coprime to it.
+    static long long limbInverse(long long x) {
+        long long inverse = 1;
+        while (x * inverse % REAL_BASE != 1) {
+            inverse += 2;
+        }
+        return inverse;
+    }
+
+    // a / b for magnitudes with b | a and b's low limb coprime to REAL_BASE, computed 1000-adically as
+    // a * b^-1 mod B^L, where L bounds the quotient's length. Short quotients or divisors cancel the low limbs one
+    // at a time; otherwise b^-1 is lifted by Newton iteration x = x * (2 - b * x) mod B^(2k).
+    static BigInteger henselQuotient(const BigInteger& a, const BigInteger& b) {
+        size_t length = a.digits.size() - b.digits.size() + 1;
+        size_t width = std::min(b.digits.size(), length);
+        if (width <= HENSEL_SCHOOLBOOK_LIMBS) {
+            std::vector<long long> rest = a.digits;
+            rest.resize(length + 1, 0);
+            long long inverse = limbInverse(b.digits[0]);
+            BigInteger quotient;
+            quotient.digits.assign(length, 0);
+            for (size_t i = 0; i < length; ++i) {
+                long long low = rest[i] % REAL_BASE;
+                long long q = (low < 0 ? low + REAL_BASE : low) * inverse % REAL_BASE;
+                quotient.digits[i] = q;
+                size_t count = std::min(b.digits.size(), length - i);
+                for (size_t j = 0; j < count; ++j) {
+                    rest[i + j] -= q * b.digits[j];
+                }
+                rest[i + 1] += rest[i] / REAL_BASE;
+            }
+            quotient.deleteZeroes();
+            return quotient;
+        }
+
+        BigInteger divisor = b;
+        divisor.keepLimbs(length);
+        BigInteger inverse = limbInverse(b.digits[0]);
+        for (size_t precision = 1; precision < length;) {
+            precision = std::min(2 * precision, length);
+            BigInteger low = divisor;
+            low.keepLimbs(precision);
+            low *= inverse;
+            low.keepLimbs(precision);
+            BigInteger correction = 2;
+            BigInteger modulus = 1;
+            modulus.multiply_pow10(DIGIT_SIZE * precision);
+            correction += modulus;
+            correction -= low;
+            inverse *= correction;
+            inverse.keepLimbs(precision);
+        }
+        BigInteger quotient = a;
+        quotient.keepLimbs(length);
+        quotient *= inverse;
+        quotient.keepLimbs(length);
+        return quotient;
+    }
+
+    bool negative() const {
+        return is_negative;
+    }
+
+    size_t capacity() const {
+        return digits.capacity();
+    }
+#else
+    static_assert(sizeof(unsigned long) == sizeof(uint64_t), "the GMP backend passes 64-bit words as unsigned long");
+
+    mpz_class value;
+
+    mpz_ptr raw() {
+        return value.get_mpz_t();
+    }
+    mpz_srcptr raw() const {
+        return value.get_mpz_t();
+    }
+
+    bool negative() const {
+        return mpz_sgn(raw()) < 0;
+    }
+
+    size_t capacity() const {
+        return static_cast<size_t>(raw()->_mp_alloc);
+    }
+
+    static mpz_class power10(size_t exponent) {
+        mpz_class power;
+        mpz_ui_pow_ui(power.get_mpz_t(), static_cast<unsigned long>(USER_BASE), exponent);
+        return power;
+    }
+
+    // Collects the digits and hands them to mpz_set_str, which converts subquadratically in every base.
+    class DigitBuilder {
+    public:
+        explicit DigitBuilder(BigInteger& target, int base = USER_BASE) : target(target), base(base) {}
+
+        void push(int digit) {
+            seen = true;
+            if (digit != 0 || !text.empty()) {
+                text += RADIX_DIGITS[digit];
+            }
+        }
+
+        bool finish(bool negative) {
+            mpz_set_str(target.raw(), text.empty() ? "0" : text.c_str(), base);
+            if (negative) {
+                target.changeSign();
+            }
+            return seen;
+        }
+
+    private:
+        BigInteger& target;
+        int base;
+        std::string text;
+        bool seen = false;
+    };
+
+    using DecimalBuilder = DigitBuilder;
+    using RadixBuilder = DigitBuilder;
+
+    // mpz_get_str writes into a per-thread scratch buffer that grows to the largest value seen on that thread.
+    std::to_chars_result toRadixChars(char* first, char* last, int base) const {
+        static thread_local std::vector<char> scratch;
+        scratch.resize(mpz_sizeinbase(raw(), base) + 2);
+        mpz_get_str(scratch.data(), base, raw());
+        std::string_view text(scratch.data() + (negative() ? 1 : 0));
+        if (static_cast<size_t>(last - first) < text.size()) {
+            return {last, std::errc::value_too_large};
+        }
+        return {std::copy(text.begin(), text.end(), first), std::errc()};
+    }
+
+    std::to_chars_result toDecimalChars(char* first, char* last) const {
+        return toRadixChars(first, last, USER_BASE);
+    }
+
+    void addProduct(const BigInteger& a, const BigInteger& b, bool subtract) {
+        if (subtract) {
+            mpz_submul(raw(), a.raw(), b.raw());
+        } else {
+            mpz_addmul(raw(), a.raw(), b.raw());
+        }
+    }
+
+    void addScaled(const BigInteger& a, unsigned long long factor, bool subtract) {
+        if (subtract) {
+            mpz_submul_ui(raw(), a.raw(), static_cast<unsigned long>(factor));
+        } else {
+            mpz_addmul_ui(raw(), a.raw(), static_cast<unsigned long>(factor));
+        }
+    }
+
+    friend BigInteger gcd(BigInteger a, BigInteger b);
+#endif
+
+
+    friend BigInteger divexact(const BigInteger& a, const BigInteger& b);
+    friend std::tuple<BigInteger, BigInteger, BigInteger> gcdext(const BigInteger& a, const BigInteger& b);
+    friend void addmul(BigInteger& acc, const BigInteger& a, const BigInteger& b);
+    friend void submul(BigInteger& acc, const BigInteger& a, const BigInteger& b);
+    friend void addmul_ui(BigInteger& acc, const BigInteger& a, unsigned long long x);
+    friend void submul_ui(BigInteger& acc, const BigInteger& a, unsigned long long x);
+    template <typename RangeA, typename RangeB>
+    friend BigInteger dot(const RangeA& a, const RangeB& b);
+
+public:
+
+    template <bigint_expr::Expression E>
+    BigInteger(const E& expression) : BigInteger() {
+        expression.assignTo(*this);
+    }
+
+    template <bigint_expr::Expression E>
+    BigInteger& operator=(const E& expression) {
+        if (expression.aliases(this)) {
+            BigInteger tmp(expression);
+            swap(tmp);
+        } else {
+            expression.assignTo(*this);
+        }
+        return *this;
+    }
+
+    template <bigint_expr::Expression E>
+    BigInteger& operator+=(const E& expression) {
+        if (expression.aliases(this)) {
+            return *this += BigInteger(expression);
+        }
+        expression.accumulateTo(*this, false);
+        return *this;
+    }
+
+    template <bigint_expr::Expression E>
+    BigInteger& operator-=(const E& expression) {
+        if (expression.aliases(this)) {
+            return *this -= BigInteger(expression);
+        }
+        expression.accumulateTo(*this, true);
+        return *this;
+    }
+
+#ifdef BIGINTEGER_USE_GMP
+    void multiply(long long x) {
+        mpz_abs(raw(), raw());
+        mpz_mul_si(raw(), raw(), static_cast<long>(x));
+    }
+
+    BigInteger() = default;
+    BigInteger(long long x) : value(static_cast<long>(x)) {}
+
+    void swap(BigInteger& x) {
+        mpz_swap(raw(), x.raw());
+    }
+
+    explicit operator bool() const {
+        return mpz_sgn(raw()) != 0;
+    }
+
+    // Three-digit limbs, as for the native representation; may count one decimal digit too many.
+    size_t size() const {
+        return (mpz_sizeinbase(raw(), USER_BASE) + DIGIT_SIZE - 1) / DIGIT_SIZE;
+    }
+
+    uint64_t hash(uint64_t seed = 0) const {
+        return hashWords(mpz_limbs_read(raw()), mpz_size(raw()), negative(), seed);
+    }
+
+    long long mod_small(long long m) const {
+        return static_cast<long long>(mpz_fdiv_ui(raw(), static_cast<unsigned long>(m)));
+    }
+
+    void applyAbs() {
+        mpz_abs(raw(), raw());
+    }
+    void changeSign() {
+        mpz_neg(raw(), raw());
+    }
+#else
+    void multiply(long long x) {
+        is_negative = false;
+        for (auto& digit : digits) {
+            digit *= x;
+        }
+        toCarry();
+        deleteZeroes();
+    }
+
+    BigInteger(): digits(1), is_negative(false) {}
+    BigInteger(long long x) : is_negative(x < 0) {
+        if (x == 0) {
+            digits.resize(1);
+            return;
+        }
+        auto value = is_negative ? 0ull - static_cast<unsigned long long>(x) : static_cast<unsigned long long>(x);
+        auto base = static_cast<unsigned long long>(REAL_BASE);
+        while (value) {
+            digits.push_back(static_cast<long long>(value % base));
+            value /= base;
+        }
+    }
+
+    void swap(BigInteger& x) {
+        std::swap(digits, x.digits);
+        std::swap(is_negative, x.is_negative);
+    }
+
+    explicit operator bool() const {
+        return digits.size() != 1 || digits[0] != 0;
+    }
+
+    size_t size() const {
+        return digits.size();
+    }
+
+    uint64_t hash(uint64_t seed = 0) const {
+        const std::vector<long long>& limbs = digits;
+        return hashWords(limbs.data(), limbs.size(), is_negative, seed);
+    }
+
+    long long mod_small(long long m) const {
+        long long rest = 0;
+        for (size_t i = digits.size(); i-- > 0;) {
+            rest = (rest * REAL_BASE + digits[i]) % m;
+        }
+        return is_negative && rest ? m - rest : rest;
+    }
+
+    void applyAbs() {
+        is_negative = false;
+    }
+    void changeSign() {
+        if (*this) {
+            is_negative = !is_negative;
+        }
+    }
+#endif
+
+
+    BigInteger operator+() const {
+        return *this;
+    }
+    BigInteger operator-() const {
+        BigInteger copy = *this;
+        copy.changeSign();
+        return copy;
+    }
+
+#ifdef BIGINTEGER_USE_GMP
+    BigInteger& operator+=(const BigInteger& x) {
+        value += x.value;
+        return *this;
+    }
+#else
+    BigInteger& operator+=(const BigInteger& x) {
+        if (x.is_negative == is_negative) {
+            if (x.digits.size() > digits.size()) {
+                digits.resize(x.digits.size());
+            }
+            long long carry = 0;
+            for (size_t i = 0; i < x.digits.size(); ++i) {
+                digits[i] += x.digits[i] + carry;
+                carry = digits[i] >= REAL_BASE;
+                if (carry) {
+                    digits[i] -= REAL_BASE;
+                }
+            }
+
+            if (carry) {
+                size_t i = x.digits.size();
+                while (i < digits.size() && digits[i] + 1 == REAL_BASE) {
+                    digits[i] = 0;
+                    ++i;
                 }
                 if (i == digits.size()) {
                     digits.push_back(0);
                 }
-                ++digits[i];
+                ++digits[i];
+            }
+        } else {
+            if (x.digits.size() >= digits.size()) {
+                digits.resize(x.digits.size());
+                size_t i = x.digits.size() - 1;
+                for (; i > 0 && digits[i] == x.digits[i]; --i) {
+                    digits.pop_back();
+                }
+                is_negative ^= digits[i] < x.digits[i];
+            }
+
+            long long carry = 0;
+            long long sign = 1 - 2 * (is_negative == x.is_negative);
+            for (size_t i = 0; i < x.digits.size(); ++i) {
+                digits[i] = sign * (digits[i] - x.digits[i]) - carry;
+                carry = digits[i] < 0;
+                if (carry) {
+                    digits[i] += REAL_BASE;
+                }
+            }
+            if (carry) {
+                size_t i = x.digits.size();
+                while (digits[i] == 0) {
+                    digits[i] = REAL_BASE - 1;
+                    ++i;
+                }
+                --digits[i];
+            }
+            deleteZeroes();
+        }
+        return *this;
+    }
+#endif
+
+    BigInteger& operator++() {
+        return *this += 1;
+    }
+    BigInteger operator++(int) {
+        BigInteger tmp = *this;
+        ++*this;
+        return tmp;
+    }
+
+    BigInteger& operator-=(const BigInteger& x) {
+        changeSign();
+        *this += x;
+        changeSign();
+        return *this;
+    }
+    BigInteger& operator--() {
+        return *this += -1;
+    }
+    BigInteger operator--(int) {
+        BigInteger tmp = *this;
+        --*this;
+        return tmp;
+    }
+
+#ifdef BIGINTEGER_USE_GMP
+    BigInteger& operator*=(const BigInteger& x) {
+        BIGINTEGER_PROFILE(Multiply, size() + x.size());
+        value *= x.value;
+        return *this;
+    }
+
+    void multiply_pow10(size_t q) {
+        value *= power10(q);
+    }
+
+    std::pair<BigInteger, BigInteger> div_mod(const BigInteger& x) const {
+        BIGINTEGER_PROFILE(DivMod, size() + x.size());
+        if (!x) {
+            throw std::domain_error("BigInteger: division by zero");
+        }
+        BigInteger div;
+        BigInteger mod;
+        mpz_tdiv_qr(div.raw(), mod.raw(), raw(), x.raw());
+        return {div, mod};
+    }
+#else
+    BigInteger& operator*=(const BigInteger& x) {
+        BIGINTEGER_PROFILE(Multiply, digits.size() + x.digits.size());
+        BIGINTEGER_NOTE_ALLOCATION(2);
+        BIGINTEGER_NOTE_GROWTH(digits.capacity(), std::max(digits.capacity(), digits.size() + x.digits.size()));
+        convolve(digits, x.digits, digits, 1, false);
+
+        toCarry();
+        is_negative ^= x.is_negative;
+        deleteZeroes();
+        return *this;
+    }
+
+    void multiply_pow10(size_t q) {
+        if (*this) {
+            digits.insert(digits.begin(), q / DIGIT_SIZE, 0);
+            if (q %= DIGIT_SIZE) {
+                long long x = USER_BASE;
+                while (--q) {
+                    x *= USER_BASE;
+                }
+                bool negative = is_negative;
+                multiply(x);
+                is_negative = negative;
+            }
+        }
+    }
+
+    std::pair<BigInteger, BigInteger> div_mod(const BigInteger& x) const {
+        BIGINTEGER_PROFILE(DivMod, digits.size() + x.digits.size());
+        BigInteger div;
+        BigInteger mod;
+        BIGINTEGER_NOTE_ALLOCATION(2);
+        for (size_t i = digits.size() - 1; i < digits.size(); --i) {
+            if (mod.digits.back()) {
+                mod.digits.insert(mod.digits.begin(), 1, digits[i]);
+            } else {
+                mod.digits[0] = digits[i];
+            }
+            div.digits.push_back(0);
+
+            if (mod >= x) {
+                long long &left = div.digits.back();
+                long long right = REAL_BASE;
+                while (left + 1 < right) {
+                    long long md = (left + right) / 2;
+                    BIGINTEGER_NOTE_ALLOCATION(1);
+                    if (::multiply(x, md) <= mod) {
+                        left = md;
+                    } else {
+                        right = md;
+                    }
+                }
+                BIGINTEGER_NOTE_ALLOCATION(1);
+                mod -= ::multiply(x, left);
+            }
+        }
+        reverse(div.digits.begin(), div.digits.end());
+        div.is_negative = is_negative ^ x.is_negative;
+        mod.is_negative = mod && is_negative;
+        div.deleteZeroes();
+        return {div, mod};
+    }
+#endif
+
+    BigInteger& operator/=(const BigInteger& x) {
+        return *this = div_mod(x).first;
+    }
+
+    BigInteger& operator%=(const BigInteger& x) {
+        return *this = div_mod(x).second;
+    }
+
+
+#ifdef BIGINTEGER_USE_GMP
+    bool operator==(const BigInteger& x) const {
+        return mpz_cmp(raw(), x.raw()) == 0;
+    }
+    friend std::strong_ordering operator<=>(const BigInteger& x, const BigInteger& y) {
+        return mpz_cmp(x.raw(), y.raw()) <=> 0;
+    }
+#else
+    bool operator==(const BigInteger&) const = default;
+    friend std::strong_ordering operator<=>(const BigInteger& x, const BigInteger& y) {
+        std::strong_ordering less = std::strong_ordering::less;
+        std::strong_ordering equal = std::strong_ordering::equal;
+        std::strong_ordering greater = std::strong_ordering::greater;
+
+        if (x.is_negative && !y.is_negative) {
+            return less;
+        }
+        if (!x.is_negative && y.is_negative) {
+            return greater;
+        }
+        if (x.is_negative) {
+            std::swap(less, greater);
+        }
+        if (x.digits.size() < y.digits.size()) {
+            return less;
+        }
+        if (x.digits.size() > y.digits.size()) {
+            return greater;
+        }
+
+        size_t i = x.digits.size() - 1;
+        while (i < x.digits.size() && x.digits[i] == y.digits[i]) {
+            --i;
+        }
+        if (i > x.digits.size()) {
+            return equal;
+        }
+
+        return x.digits[i] < y.digits[i] ? less : greater;
+    }
+#endif
+
+    std::string toString(int base = 10) const {
+        BIGINTEGER_PROFILE(ToString, size());
+        checkRadix(base);
+        std::string s(base == USER_BASE ? decimal_size_hint() : radixSizeHint(base), '\0');
+        BIGINTEGER_NOTE_ALLOCATION(1);
+        auto result = to_chars(s.data(), s.data() + s.size(), *this, base);
+        if (result.ec != std::errc{}) {
+            throw std::logic_error("BigInteger: size hint too small for toString");
+        }
+        s.resize(static_cast<size_t>(result.ptr - s.data()));
+        return s;
+    }
+
+#ifdef BIGINTEGER_USE_GMP
+    size_t decimal_size_hint() const {
+        return mpz_sizeinbase(raw(), USER_BASE) + negative();
+    }
+
+    size_t radixSizeHint(int base) const {
+        checkRadix(base);
+        return mpz_sizeinbase(raw(), base) + negative();
+    }
+#else
+    size_t decimal_size_hint() const {
+        return DIGIT_SIZE * digits.size() + is_negative;
+    }
+
+    size_t radixSizeHint(int base) const {
+        checkRadix(base);
+        size_t bits = 10 * digits.size();
+        return bits / static_cast<size_t>(std::bit_width(static_cast<unsigned>(base)) - 1) + 1 + is_negative;
+    }
+#endif
+
+    // Only base 10 is allocation-free. Other bases divide a per-thread scratch copy of the limbs, which grows to
+    // the largest value seen on that thread, and power-of-two bases above RADIX_SPLIT_THRESHOLD limbs also build a
+    // table of powers for the divide-and-conquer split.
+    friend std::to_chars_result to_chars(char* first, char* last, const BigInteger& x, int base = 10) {
+        if (base < 2 || base > 36) {
+            return {last, std::errc::invalid_argument};
+        }
+        char* ptr = first;
+        if (x.negative()) {
+            if (ptr == last) {
+                return {last, std::errc::value_too_large};
+            }
+            *ptr++ = '-';
+        }
+        if (base == USER_BASE) {
+            return x.toDecimalChars(ptr, last);
+        }
+        return x.toRadixChars(ptr, last, base);
+    }
+
+    friend std::from_chars_result from_chars(const char* first, const char* last, BigInteger& x, int base = 10) {
+        if (base < 2 || base > 36) {
+            return {first, std::errc::invalid_argument};
+        }
+        const char* ptr = first;
+        bool negative = ptr != last && *ptr == '-';
+        if (negative) {
+            ++ptr;
+        }
+        if (ptr == last || digitValue(*ptr) >= base) {
+            return {first, std::errc::invalid_argument};
+        }
+        auto next = [&ptr, last]() {
+            return ++ptr == last ? std::char_traits<char>::eof() : *ptr;
+        };
+        if (base == USER_BASE) {
+            DecimalBuilder builder(x);
+            readDigits(builder, base, *ptr, next);
+            builder.finish(negative);
+        } else {
+            RadixBuilder builder(x, base);
+            readDigits(builder, base, *ptr, next);
+            builder.finish(negative);
+        }
+        return {ptr, std::errc()};
+    }
+
+    friend std::istream& operator>>(std::istream& in, BigInteger& x) {
+        BIGINTEGER_PROFILE(Read, 0);
+        std::istream::sentry sentry(in);
+        if (!sentry) {
+            return in;
+        }
+        std::streambuf* buffer = in.rdbuf();
+        int c = buffer->sgetc();
+        bool negative = c == '-';
+        if (c == '-' || c == '+') {
+            c = buffer->snextc();
+        }
+
+        int base = 0;
+        switch (in.flags() & std::ios_base::basefield) {
+            case std::ios_base::hex:
+                base = 16;
+                break;
+            case std::ios_base::oct:
+                base = 8;
+                break;
+            case std::ios_base::dec:
+                base = 10;
+                break;
+            default:
+                break;
+        }
+        bool leading_zero = false;
+        if ((base == 0 || base == 16) && c == '0') {
+            c = buffer->snextc();
+            if (c == 'x' || c == 'X') {
+                base = 16;
+                c = buffer->snextc();
+            } else {
+                leading_zero = true;
+                base = base == 0 ? 8 : base;
+            }
+        }
+        base = base == 0 ? 10 : base;
+
+        auto next = [buffer]() {
+            return buffer->snextc();
+        };
+        bool eof = false;
+        bool success = false;
+        if (base == USER_BASE) {
+            DecimalBuilder builder(x);
+            if (leading_zero) {
+                builder.push(0);
+            }
+            eof = readDigits(builder, base, c, next);
+            success = builder.finish(negative);
+        } else {
+            RadixBuilder builder(x, base);
+            if (leading_zero) {
+                builder.push(0);
+            }
+            eof = readDigits(builder, base, c, next);
+            success = builder.finish(negative);
+        }
+        BIGINTEGER_NOTE_LIMBS(x.size());
+        BIGINTEGER_NOTE_GROWTH(0, x.capacity());
+        in.setstate((eof ? std::ios_base::eofbit : std::ios_base::goodbit) |
+                    (success ? std::ios_base::goodbit : std::ios_base::failbit));
+        return in;
+    }
+
+    explicit BigInteger(std::string_view s, int base = 10) : BigInteger() {
+        auto [ptr, error] = from_chars(s.data(), s.data() + s.size(), *this, base);
+        if (error != std::errc() || ptr != s.data() + s.size()) {
+            throw std::invalid_argument("BigInteger: malformed integer string");
+        }
+    }
+
+};
+
+BigInteger multiply(BigInteger ans, long long x) {
+    ans.multiply(x);
+    return ans;
+}
+
+std::ostream& operator<<(std::ostream& out, const BigInteger& x) {
+    std::ios_base::fmtflags flags = out.flags();
+    int base = 10;
+    if ((flags & std::ios_base::basefield) == std::ios_base::hex) {
+        base = 16;
+    } else if ((flags & std::ios_base::basefield) == std::ios_base::oct) {
+        base = 8;
+    }
+    std::string s = x.toString(base);
+    size_t sign = x < 0 ? 1 : 0;
+    if ((flags & std::ios_base::showbase) && base == 16) {
+        s.insert(sign, "0x");
+    } else if ((flags & std::ios_base::showbase) && base == 8 && x) {
+        s.insert(sign, "0");
+    }
+    if (flags & std::ios_base::uppercase) {
+        std::transform(s.begin(), s.end(), s.begin(), [](char c) {
+            return 'a' <= c && c <= 'z' ? static_cast<char>(c - 'a' + 'A') : c;
+        });
+    }
+    if ((flags & std::ios_base::showpos) && sign == 0) {
+        s.insert(s.begin(), '+');
+    }
+    return out << s;
+}
+
+template <size_t Bits>
+class FixedBigInt {
+private:
+    static_assert(Bits > 0 && Bits % 32 == 0, "FixedBigInt width must be a positive multiple of 32");
+
+    static constexpr size_t LIMBS = Bits / 32;
+    static constexpr uint64_t LIMB_BASE = uint64_t(1) << 32;
+
+    template <size_t>
+    friend class FixedBigInt;
+
+    std::array<uint32_t, LIMBS> limbs{};
+
+    constexpr void negate() {
+        bool carry = true;
+        for (auto& limb : limbs) {
+            limb = ~limb + carry;
+            carry = carry && limb == 0;
+        }
+    }
+
+    constexpr size_t significantLimbs() const {
+        size_t n = LIMBS;
+        while (n > 0 && limbs[n - 1] == 0) {
+            --n;
+        }
+        return n;
+    }
+
+    static constexpr void divModUnsigned(const FixedBigInt& u, const FixedBigInt& v,
+                                         FixedBigInt& quotient, FixedBigInt& remainder) {
+        size_t n = v.significantLimbs();
+        size_t m = u.significantLimbs();
+        if (n == 0) {
+            throw std::domain_error("FixedBigInt division by zero");
+        }
+        quotient = FixedBigInt();
+        remainder = FixedBigInt();
+        if (m < n) {
+            remainder = u;
+            return;
+        }
+        if (n == 1) {
+            uint64_t rest = 0;
+            for (size_t i = m; i-- > 0;) {
+                uint64_t cur = (rest << 32) | u.limbs[i];
+                quotient.limbs[i] = static_cast<uint32_t>(cur / v.limbs[0]);
+                rest = cur % v.limbs[0];
+            }
+            remainder.limbs[0] = static_cast<uint32_t>(rest);
+            return;
+        }
+
+        int shift = std::countl_zero(v.limbs[n - 1]);
+        std::array<uint32_t, LIMBS> vn{};
+        std::array<uint32_t, LIMBS + 1> un{};
+        for (size_t i = n - 1; i > 0; --i) {
+            vn[i] = (v.limbs[i] << shift) | static_cast<uint32_t>(uint64_t(v.limbs[i - 1]) >> (32 - shift));
+        }
+        vn[0] = v.limbs[0] << shift;
+        un[m] = static_cast<uint32_t>(uint64_t(u.limbs[m - 1]) >> (32 - shift));
+        for (size_t i = m - 1; i > 0; --i) {
+            un[i] = (u.limbs[i] << shift) | static_cast<uint32_t>(uint64_t(u.limbs[i - 1]) >> (32 - shift));
+        }
+        un[0] = u.limbs[0] << shift;
+
+        for (size_t j = m - n + 1; j-- > 0;) {
+            uint64_t numerator = (uint64_t(un[j + n]) << 32) | un[j + n - 1];
+            uint64_t qhat = numerator / vn[n - 1];
+            uint64_t rhat = numerator % vn[n - 1];
+            while (qhat >= LIMB_BASE || qhat * vn[n - 2] > ((rhat << 32) | un[j + n - 2])) {
+                --qhat;
+                rhat += vn[n - 1];
+                if (rhat >= LIMB_BASE) {
+                    break;
+                }
+            }
+
+            int64_t borrow = 0;
+            int64_t t = 0;
+            for (size_t i = 0; i < n; ++i) {
+                uint64_t product = qhat * vn[i];
+                t = static_cast<int64_t>(un[i + j]) - borrow - static_cast<int64_t>(product & 0xFFFFFFFFu);
+                un[i + j] = static_cast<uint32_t>(t);
+                borrow = static_cast<int64_t>(product >> 32) - (t >> 32);
+            }
+            t = static_cast<int64_t>(un[j + n]) - borrow;
+            un[j + n] = static_cast<uint32_t>(t);
+
+            quotient.limbs[j] = static_cast<uint32_t>(qhat);
+            if (t < 0) {
+                --quotient.limbs[j];
+                uint64_t carry = 0;
+                for (size_t i = 0; i < n; ++i) {
+                    uint64_t sum = uint64_t(un[i + j]) + vn[i] + carry;
+                    un[i + j] = static_cast<uint32_t>(sum);
+                    carry = sum >> 32;
+                }
+                un[j + n] += static_cast<uint32_t>(carry);
+            }
+        }
+
+        for (size_t i = 0; i + 1 < n; ++i) {
+            remainder.limbs[i] = (un[i] >> shift) | static_cast<uint32_t>(uint64_t(un[i + 1]) << (32 - shift));
+        }
+        remainder.limbs[n - 1] = un[n - 1] >> shift;
+    }
+
+public:
+    constexpr FixedBigInt() = default;
+    constexpr FixedBigInt(long long x) {
+        auto bits = static_cast<uint64_t>(x);
+        limbs[0] = static_cast<uint32_t>(bits);
+        if constexpr (LIMBS > 1) {
+            limbs[1] = static_cast<uint32_t>(bits >> 32);
+        }
+        for (size_t i = 2; i < LIMBS; ++i) {
+            limbs[i] = x < 0 ? ~uint32_t(0) : 0;
+        }
+    }
+
+    template <size_t OtherBits>
+    constexpr explicit FixedBigInt(const FixedBigInt<OtherBits>& x) {
+        uint32_t fill = x.isNegative() ? ~uint32_t(0) : 0;
+        for (size_t i = 0; i < LIMBS; ++i) {
+            limbs[i] = i < x.LIMBS ? x.limbs[i] : fill;
+        }
+    }
+
+    explicit FixedBigInt(const BigInteger& x) {
+#ifdef BIGINTEGER_USE_GMP
+        std::vector<uint32_t> words((mpz_sizeinbase(x.raw(), 2) + 31) / 32);
+        size_t count = 0;
+        mpz_export(words.data(), &count, -1, sizeof(uint32_t), 0, 0, x.raw());
+        std::copy_n(words.begin(), std::min(count, LIMBS), limbs.begin());
+#else
+        for (size_t i = x.digits.size(); i-- > 0;) {
+            mulAddSmall(static_cast<uint32_t>(BigInteger::REAL_BASE), static_cast<uint32_t>(x.digits[i]));
+        }
+#endif
+        if (x.negative()) {
+            negate();
+        }
+    }
+
+    operator BigInteger() const {
+        FixedBigInt magnitude = abs();
+        BigInteger result;
+        for (size_t i = LIMBS; i-- > 0;) {
+            result.multiply(static_cast<long long>(LIMB_BASE));
+            result += static_cast<long long>(magnitude.limbs[i]);
+        }
+        if (isNegative()) {
+            result.changeSign();
+        }
+        return result;
+    }
+
+    constexpr explicit operator bool() const {
+        return significantLimbs() != 0;
+    }
+
+    constexpr bool isNegative() const {
+        return (limbs.back() >> 31) != 0;
+    }
+
+    constexpr FixedBigInt abs() const {
+        return isNegative() ? -*this : *this;
+    }
+
+    constexpr void mulAddSmall(uint32_t factor, uint32_t addend) {
+        uint64_t carry = addend;
+        for (auto& limb : limbs) {
+            uint64_t cur = uint64_t(limb) * factor + carry;
+            limb = static_cast<uint32_t>(cur);
+            carry = cur >> 32;
+        }
+    }
+
+    constexpr FixedBigInt operator+() const {
+        return *this;
+    }
+    constexpr FixedBigInt operator-() const {
+        FixedBigInt copy = *this;
+        copy.negate();
+        return copy;
+    }
+
+    constexpr FixedBigInt& operator+=(const FixedBigInt& x) {
+        uint64_t carry = 0;
+        for (size_t i = 0; i < LIMBS; ++i) {
+            uint64_t sum = uint64_t(limbs[i]) + x.limbs[i] + carry;
+            limbs[i] = static_cast<uint32_t>(sum);
+            carry = sum >> 32;
+        }
+        return *this;
+    }
+    constexpr FixedBigInt& operator-=(const FixedBigInt& x) {
+        return *this += -x;
+    }
+
+    constexpr FixedBigInt& operator++() {
+        return *this += 1;
+    }
+    constexpr FixedBigInt operator++(int) {
+        FixedBigInt tmp = *this;
+        ++*this;
+        return tmp;
+    }
+    constexpr FixedBigInt& operator--() {
+        return *this -= 1;
+    }
+    constexpr FixedBigInt operator--(int) {
+        FixedBigInt tmp = *this;
+        --*this;
+        return tmp;
+    }
+
+    constexpr FixedBigInt& operator*=(const FixedBigInt& x) {
+        std::array<uint32_t, LIMBS> result{};
+        for (size_t i = 0; i < LIMBS; ++i) {
+            uint64_t carry = 0;
+            for (size_t j = 0; i + j < LIMBS; ++j) {
+                uint64_t cur = result[i + j] + uint64_t(limbs[i]) * x.limbs[j] + carry;
+                result[i + j] = static_cast<uint32_t>(cur);
+                carry = cur >> 32;
+            }
+        }
+        limbs = result;
+        return *this;
+    }
+
+    constexpr std::pair<FixedBigInt, FixedBigInt> div_mod(const FixedBigInt& x) const {
+        FixedBigInt div;
+        FixedBigInt mod;
+        divModUnsigned(abs(), x.abs(), div, mod);
+        if (isNegative() != x.isNegative()) {
+            div.negate();
+        }
+        if (isNegative()) {
+            mod.negate();
+        }
+        return {div, mod};
+    }
+
+    constexpr FixedBigInt& operator/=(const FixedBigInt& x) {
+        return *this = div_mod(x).first;
+    }
+    constexpr FixedBigInt& operator%=(const FixedBigInt& x) {
+        return *this = div_mod(x).second;
+    }
+
+    constexpr FixedBigInt& operator<<=(size_t shift) {
+        if (shift >= Bits) {
+            return *this = FixedBigInt();
+        }
+        size_t whole = shift / 32;
+        int part = static_cast<int>(shift % 32);
+        for (size_t i = LIMBS; i-- > 0;) {
+            uint64_t cur = i >= whole ? uint64_t(limbs[i - whole]) << 32 : 0;
+            if (i > whole) {
+                cur |= limbs[i - whole - 1];
+            }
+            limbs[i] = static_cast<uint32_t>(cur >> (32 - part));
+        }
+        return *this;
+    }
+    constexpr FixedBigInt& operator>>=(size_t shift) {
+        uint32_t fill = isNegative() ? ~uint32_t(0) : 0;
+        if (shift >= Bits) {
+            limbs.fill(fill);
+            return *this;
+        }
+        size_t whole = shift / 32;
+        int part = static_cast<int>(shift % 32);
+        for (size_t i = 0; i < LIMBS; ++i) {
+            uint64_t low = i + whole < LIMBS ? limbs[i + whole] : fill;
+            uint64_t high = i + whole + 1 < LIMBS ? limbs[i + whole + 1] : fill;
+            limbs[i] = static_cast<uint32_t>(((high << 32) | low) >> part);
+        }
+        return *this;
+    }
+
+    constexpr bool operator==(const FixedBigInt&) const = default;
+    friend constexpr std::strong_ordering operator<=>(const FixedBigInt& x, const FixedBigInt& y) {
+        if (x.isNegative() != y.isNegative()) {
+            return x.isNegative() ? std::strong_ordering::less : std::strong_ordering::greater;
+        }
+        for (size_t i = LIMBS; i-- > 0;) {
+            if (x.limbs[i] != y.limbs[i]) {
+                return x.limbs[i] <=> y.limbs[i];
+            }
+        }
+        return std::strong_ordering::equal;
+    }
+
+    std::string toString() const {
+        return BigInteger(*this).toString();
+    }
+};
+
+template <size_t Bits>
+constexpr FixedBigInt<Bits> operator+(FixedBigInt<Bits> x, const FixedBigInt<Bits>& y) {
+    x += y;
+    return x;
+}
+template <size_t Bits>
+constexpr FixedBigInt<Bits> operator-(FixedBigInt<Bits> x, const FixedBigInt<Bits>& y) {
+    x -= y;
+    return x;
+}
+template <size_t Bits>
+constexpr FixedBigInt<Bits> operator*(FixedBigInt<Bits> x, const FixedBigInt<Bits>& y) {
+    x *= y;
+    return x;
+}
+template <size_t Bits>
+constexpr FixedBigInt<Bits> operator/(FixedBigInt<Bits> x, const FixedBigInt<Bits>& y) {
+    x /= y;
+    return x;
+}
+template <size_t Bits>
+constexpr FixedBigInt<Bits> operator%(FixedBigInt<Bits> x, const FixedBigInt<Bits>& y) {
+    x %= y;
+    return x;
+}
+template <size_t Bits>
+constexpr FixedBigInt<Bits> operator<<(FixedBigInt<Bits> x, size_t shift) {
+    x <<= shift;
+    return x;
+}
+template <size_t Bits>
+constexpr FixedBigInt<Bits> operator>>(FixedBigInt<Bits> x, size_t shift) {
+    x >>= shift;
+    return x;
+}
+
+template <size_t Bits>
+std::ostream& operator<<(std::ostream& out, const FixedBigInt<Bits>& x) {
+    return out << x.toString();
+}
+
+namespace {
+    template <char... Chars>
+    struct IntegerLiteral {
+        static constexpr std::array<char, sizeof...(Chars)> text{Chars...};
+
+        static constexpr uint32_t base() {
+            if (text.size() > 1 && text[0] == '0') {
+                if (text[1] == 'x' || text[1] == 'X') {
+                    return 16;
+                }
+                if (text[1] == 'b' || text[1] == 'B') {
+                    return 2;
+                }
+                return 8;
+            }
+            return 10;
+        }
+
+        static constexpr size_t prefix() {
+            return base() == 16 || base() == 2 ? 2 : 0;
+        }
+
+        static constexpr size_t bits() {
+            size_t count = 0;
+            for (size_t i = prefix(); i < text.size(); ++i) {
+                count += text[i] != '\'';
+            }
+            size_t value_bits = 0;
+            switch (base()) {
+                case 2:
+                    value_bits = count;
+                    break;
+                case 8:
+                    value_bits = 3 * count;
+                    break;
+                case 16:
+                    value_bits = 4 * count;
+                    break;
+                default:
+                    value_bits = (3322 * count + 999) / 1000;
+            }
+            return (value_bits + 1 + 31) / 32 * 32;
+        }
+
+        template <size_t Bits>
+        static constexpr FixedBigInt<Bits> parse() {
+            FixedBigInt<Bits> value;
+            for (size_t i = prefix(); i < text.size(); ++i) {
+                char c = text[i];
+                if (c == '\'') {
+                    continue;
+                }
+                uint32_t digit = base();
+                if ('0' <= c && c <= '9') {
+                    digit = static_cast<uint32_t>(c - '0');
+                } else if ('a' <= c && c <= 'f') {
+                    digit = static_cast<uint32_t>(c - 'a' + 10);
+                } else if ('A' <= c && c <= 'F') {
+                    digit = static_cast<uint32_t>(c - 'A' + 10);
+                }
+                if (digit >= base()) {
+                    throw std::invalid_argument("invalid digit in integer literal");
+                }
+                value.mulAddSmall(base(), digit);
+            }
+            return value;
+        }
+    };
+}
+
+template <char... Chars>
+constexpr auto operator""_fbi() {
+    using Literal = IntegerLiteral<Chars...>;
+    return Literal::template parse<Literal::bits()>();
+}
+
+template <char... Chars>
+BigInteger operator""_bi() {
+    constexpr auto value = operator""_fbi<Chars...>();
+    return value;
+}
+
+BigInteger operator+(BigInteger x, const BigInteger& y) {
+    x += y;
+    return x;
+}
+BigInteger operator-(BigInteger x, const BigInteger& y) {
+    x -= y;
+    return x;
+}
+BigInteger operator*(BigInteger x, const BigInteger& y) {
+    x *= y;
+    return x;
+}
+BigInteger operator/(BigInteger x, const BigInteger& y) {
+    x /= y;
+    return x;
+}
+BigInteger operator%(BigInteger x, const BigInteger& y) {
+    x %= y;
+    return x;
+}
+
+
+namespace bigint_expr {
+    struct Ref {
+        using is_expression = void;
+        using is_leaf = void;
+        const BigInteger* value;
+
+        const BigInteger& get() const {
+            return *value;
+        }
+        void assignTo(BigInteger& dest) const {
+            dest = *value;
+        }
+        void accumulateTo(BigInteger& dest, bool subtract) const {
+            if (subtract) {
+                dest -= *value;
+            } else {
+                dest += *value;
+            }
+        }
+        bool aliases(const BigInteger* target) const {
+            return value == target;
+        }
+    };
+
+    struct Owned {
+        using is_expression = void;
+        using is_leaf = void;
+        BigInteger value;
+
+        const BigInteger& get() const {
+            return value;
+        }
+        void assignTo(BigInteger& dest) const {
+            dest = value;
+        }
+        void accumulateTo(BigInteger& dest, bool subtract) const {
+            if (subtract) {
+                dest -= value;
+            } else {
+                dest += value;
+            }
+        }
+        bool aliases(const BigInteger*) const {
+            return false;
+        }
+    };
+
+    template <typename Node>
+    decltype(auto) materialize(const Node& node) {
+        if constexpr (requires { typename Node::is_leaf; }) {
+            return node.get();
+        } else {
+            BigInteger value;
+            node.assignTo(value);
+            return value;
+        }
+    }
+
+    template <typename Left, typename Right>
+    struct Product {
+        using is_expression = void;
+        Left left;
+        Right right;
+
+        void assignTo(BigInteger& dest) const {
+            left.assignTo(dest);
+            dest *= materialize(right);
+        }
+        void accumulateTo(BigInteger& dest, bool subtract) const {
+            dest.addProduct(materialize(left), materialize(right), subtract);
+        }
+        bool aliases(const BigInteger* target) const {
+            return left.aliases(target) || right.aliases(target);
+        }
+    };
+
+    template <typename Left, typename Right, bool Subtract>
+    struct Sum {
+        using is_expression = void;
+        Left left;
+        Right right;
+
+        void assignTo(BigInteger& dest) const {
+            left.assignTo(dest);
+            right.accumulateTo(dest, Subtract);
+        }
+        void accumulateTo(BigInteger& dest, bool subtract) const {
+            left.accumulateTo(dest, subtract);
+            right.accumulateTo(dest, subtract != Subtract);
+        }
+        bool aliases(const BigInteger* target) const {
+            return left.aliases(target) || right.aliases(target);
+        }
+    };
+
+    template <typename Inner>
+    struct Negate {
+        using is_expression = void;
+        Inner inner;
+
+        void assignTo(BigInteger& dest) const {
+            inner.assignTo(dest);
+            dest.changeSign();
+        }
+        void accumulateTo(BigInteger& dest, bool subtract) const {
+            inner.accumulateTo(dest, !subtract);
+        }
+        bool aliases(const BigInteger* target) const {
+            return inner.aliases(target);
+        }
+    };
+
+    template <typename T>
+    auto wrap(T&& x) {
+        using Decayed = std::remove_cvref_t<T>;
+        if constexpr (Expression<Decayed>) {
+            return Decayed(std::forward<T>(x));
+        } else if constexpr (std::is_same_v<Decayed, BigInteger> && std::is_lvalue_reference_v<T>) {
+            return Ref{&x};
+        } else {
+            return Owned{BigInteger(std::forward<T>(x))};
+        }
+    }
+
+    template <typename L, typename R>
+    concept Operands = (Expression<std::remove_cvref_t<L>> || Expression<std::remove_cvref_t<R>>) &&
+                       (Expression<std::remove_cvref_t<L>> || std::is_convertible_v<L, BigInteger>) &&
+                       (Expression<std::remove_cvref_t<R>> || std::is_convertible_v<R, BigInteger>);
+
+    template <typename L, typename R>
+    requires Operands<L, R>
+    auto operator*(L&& left, R&& right) {
+        return Product<decltype(wrap(std::forward<L>(left))), decltype(wrap(std::forward<R>(right)))>{
+            wrap(std::forward<L>(left)), wrap(std::forward<R>(right))};
+    }
+
+    template <typename L, typename R>
+    requires Operands<L, R>
+    auto operator+(L&& left, R&& right) {
+        return Sum<decltype(wrap(std::forward<L>(left))), decltype(wrap(std::forward<R>(right))), false>{
+            wrap(std::forward<L>(left)), wrap(std::forward<R>(right))};
+    }
+
+    template <typename L, typename R>
+    requires Operands<L, R>
+    auto operator-(L&& left, R&& right) {
+        return Sum<decltype(wrap(std::forward<L>(left))), decltype(wrap(std::forward<R>(right))), true>{
+            wrap(std::forward<L>(left)), wrap(std::forward<R>(right))};
+    }
+
+    template <Expression E>
+    Negate<E> operator-(const E& expression) {
+        return {expression};
+    }
+}
+
+void addmul(BigInteger& acc, const BigInteger& a, const BigInteger& b) {
+    acc.addProduct(a, b, false);
+}
+void submul(BigInteger& acc, const BigInteger& a, const BigInteger& b) {
+    acc.addProduct(a, b, true);
+}
+void addmul_ui(BigInteger& acc, const BigInteger& a, unsigned long long x) {
+    acc.addScaled(a, x, false);
+}
+void submul_ui(BigInteger& acc, const BigInteger& a, unsigned long long x) {
+    acc.addScaled(a, x, true);
+}
+
+template <typename RangeA, typename RangeB>
+BigInteger dot(const RangeA& a, const RangeB& b) {
+    BigInteger result;
+#ifdef BIGINTEGER_USE_GMP
+    auto right = std::begin(b);
+    for (auto left = std::begin(a); left != std::end(a) && right != std::end(b); ++left, ++right) {
+        addmul(result, *left, *right);
+    }
+#else
+    unsigned long long bound = 0;
+    auto left = std::begin(a);
+    auto right = std::begin(b);
+    for (; left != std::end(a) && right != std::end(b); ++left, ++right) {
+        const BigInteger& x = *left;
+        const BigInteger& y = *right;
+        unsigned long long term = std::min(x.digits.size(), y.digits.size()) *
+                                  static_cast<unsigned long long>(BigInteger::REAL_BASE * BigInteger::REAL_BASE);
+        if (bound + term > BigInteger::DOT_HEADROOM) {
+            result.normalizeSigned();
+            bound = BigInteger::REAL_BASE;
+        }
+        BigInteger::convolve(x.digits, y.digits, result.digits,
+                             (x.is_negative != y.is_negative) != result.is_negative ? -1 : 1, true);
+        bound += term;
+    }
+    result.normalizeSigned();
+#endif
+    return result;
+}
+
+bigint_expr::Ref lazy(const BigInteger& x) {
+    return {&x};
+}
+bigint_expr::Ref lazy(const BigInteger&&) = delete;
+
+// A fixed factor whose transforms are kept between multiplications, so each product only transforms the other
+// operand. Transforms are computed on first use for each length and shared by copies of the handle. The GMP
+// backend keeps no transforms and multiplies directly.
+class PreparedMultiplier {
+public:
+#ifdef BIGINTEGER_USE_GMP
+    explicit PreparedMultiplier(BigInteger factor) : factor(std::move(factor)) {}
+#else
+    explicit PreparedMultiplier(BigInteger factor) : factor(std::move(factor)), cache(std::make_shared<Cache>()) {}
+#endif
+
+    const BigInteger& value() const {
+        return factor;
+    }
+
+    BigInteger multiply(const BigInteger& x) const {
+#ifdef BIGINTEGER_USE_GMP
+        return x * factor;
+#else
+        const std::vector<long long>& a = x.digits;
+        const std::vector<long long>& b = factor.digits;
+        if (std::min(a.size(), b.size()) <= BigInteger::FFT_SCHOOLBOOK_LIMBS ||
+            b.size() >= BigInteger::FFT_UNBALANCED_RATIO * a.size()) {
+            return x * factor;
+        }
+
+        std::vector<long long> product(a.size() + b.size() - 1);
+        bool transformed = false;
+        if (a.size() >= BigInteger::FFT_UNBALANCED_RATIO * b.size()) {
+            std::shared_ptr<const Transform> t = transform(BigInteger::chunkLength(b.size()));
+            transformed = BigInteger::chunkedProduct(a, b.size(), t->spectrum, t->norm, product);
+        } else {
+            std::shared_ptr<const Transform> t = transform(fftLength(product.size()));
+            transformed = BigInteger::preparedProduct(a, t->spectrum, t->norm, product);
+        }
+        if (!transformed) {
+            return x * factor;
+        }
+
+        BigInteger result;
+        std::vector<long long>& limbs = result.digits;
+        limbs = std::move(product);
+        result.toCarry();
+        result.is_negative = x.is_negative != factor.is_negative;
+        result.deleteZeroes();
+        return result;
+#endif
+    }
+
+    friend BigInteger operator*(const BigInteger& x, const PreparedMultiplier& m) {
+        return m.multiply(x);
+    }
+
+    friend BigInteger operator*(const PreparedMultiplier& m, const BigInteger& x) {
+        return m.multiply(x);
+    }
+
+private:
+    BigInteger factor;
+
+#ifndef BIGINTEGER_USE_GMP
+    struct Transform {
+        std::vector<std::complex<double>> spectrum;
+        double norm = 0;
+    };
+
+    struct Cache {
+        std::mutex mutex;
+        std::vector<std::shared_ptr<const Transform>> transforms;
+    };
+
+    std::shared_ptr<Cache> cache;
+
+    std::shared_ptr<const Transform> transform(size_t length) const {
+        std::lock_guard<std::mutex> lock(cache->mutex);
+        for (const auto& t : cache->transforms) {
+            if (t->spectrum.size() == length) {
+                return t;
+            }
+        }
+        auto t = std::make_shared<Transform>();
+        t->spectrum = BigInteger::realSpectrum(factor.digits, length, t->norm);
+        cache->transforms.push_back(t);
+        return t;
+    }
+#endif
+};
+
+// Division by a fixed divisor with the quotient truncated toward zero, like BigInteger::div_mod. A single-limb
+// divisor uses a multiply-and-shift reciprocal. A divisor of k limbs keeps R = floor(B^(2k) / |d|), computed by
+// Newton iteration, and divides by Barrett reduction on blocks of k limbs, so a division costs multiplications by
+// the prepared R and |d| only. The GMP backend forwards to mpz division.
+class Divisor {
+public:
+#ifdef BIGINTEGER_USE_GMP
+    explicit Divisor(BigInteger divisor) : divisor(nonZero(std::move(divisor))) {}
+#else
+    explicit Divisor(BigInteger divisor)
+        : divisor(nonZero(std::move(divisor))),
+          magnitude(absolute(this->divisor)),
+          limbs(magnitude.digits.size()),
+          magic(limbs == 1 ? (uint64_t{1} << SHORT_SHIFT) / static_cast<uint64_t>(magnitude.digits[0]) + 1 : 0),
+          scaled(magnitude),
+          inverse(limbs > 1 ? reciprocal(magnitude) : BigInteger()) {}
+#endif
+
+    const BigInteger& value() const {
+        return divisor;
+    }
+
+    std::pair<BigInteger, BigInteger> div_mod(const BigInteger& x) const {
+#ifdef BIGINTEGER_USE_GMP
+        return x.div_mod(divisor);
+#else
+        BIGINTEGER_PROFILE(DivMod, x.digits.size() + limbs);
+        auto [div, mod] = limbs == 1 ? shortDivMod(x) : blockDivMod(absolute(x));
+        div.is_negative = x.is_negative != divisor.is_negative;
+        mod.is_negative = x.is_negative;
+        div.deleteZeroes();
+        mod.deleteZeroes();
+        return {div, mod};
+#endif
+    }
+
+    BigInteger div(const BigInteger& x) const {
+        return div_mod(x).first;
+    }
+
+    BigInteger mod(const BigInteger& x) const {
+        return div_mod(x).second;
+    }
+
+    friend BigInteger operator/(const BigInteger& x, const Divisor& d) {
+        return d.div(x);
+    }
+
+    friend BigInteger operator%(const BigInteger& x, const Divisor& d) {
+        return d.mod(x);
+    }
+
+private:
+    BigInteger divisor;
+
+    static BigInteger nonZero(BigInteger x) {
+        if (!x) {
+            throw std::domain_error("Divisor: division by zero");
+        }
+        return x;
+    }
+
+#ifndef BIGINTEGER_USE_GMP
+    // Exact for every dividend below BigInteger::REAL_BASE^2: the reciprocal's error times the dividend stays
+    // below 2^SHORT_SHIFT.
+    static const int SHORT_SHIFT = 40;
+    static const size_t NEWTON_THRESHOLD = 16;
+
+    BigInteger magnitude;
+    size_t limbs;
+    uint64_t magic;
+    PreparedMultiplier scaled;
+    PreparedMultiplier inverse;
+
+    static BigInteger absolute(BigInteger x) {
+        x.applyAbs();
+        return x;
+    }
+
+    static BigInteger limbPower(size_t count) {
+        BigInteger power = 1;
+        power.multiply_pow10(BigInteger::DIGIT_SIZE * count);
+        return power;
+    }
+
+    // floor(B^(2k) / m) for m of k limbs: the reciprocal of m's top limbs, scaled up, is refined by one Newton
+    // step x += x * (B^(2k) - m * x) / B^(2k), which leaves an error of a few units to step off.
+    static BigInteger reciprocal(const BigInteger& m) {
+        size_t k = m.digits.size();
+        BigInteger power = limbPower(2 * k);
+        if (k <= NEWTON_THRESHOLD) {
+            return power / m;
+        }
+        size_t h = (k + 3) / 2 + 2;
+        BigInteger top = m;
+        top.dropLimbs(k - h);
+        BigInteger x = reciprocal(top);
+        x.multiply_pow10(BigInteger::DIGIT_SIZE * (k - h));
+
+        BigInteger error = power;
+        error -= m * x;
+        BigInteger step = x * error;
+        step.dropLimbs(2 * k);
+        x += step;
+
+        BigInteger rest = power;
+        rest -= m * x;
+        while (rest < 0) {
+            x -= 1;
+            rest += m;
+        }
+        while (rest >= m) {
+            x += 1;
+            rest -= m;
+        }
+        return x;
+    }
+
+    std::pair<BigInteger, BigInteger> shortDivMod(const BigInteger& x) const {
+        auto d = static_cast<uint64_t>(magnitude.digits[0]);
+        BigInteger div;
+        std::vector<long long>& quotient = div.digits;
+        quotient.assign(x.digits.size(), 0);
+        uint64_t rest = 0;
+        for (size_t i = x.digits.size(); i-- > 0;) {
+            uint64_t current = rest * BigInteger::REAL_BASE + static_cast<uint64_t>(x.digits[i]);
+            uint64_t q = (current * magic) >> SHORT_SHIFT;
+            quotient[i] = static_cast<long long>(q);
+            rest = current - q * d;
+        }
+        return {div, BigInteger(static_cast<long long>(rest))};
+    }
+
+    // Barrett step for 0 <= a < B^(2k): the estimate floor(floor(a / B^(k-1)) * R / B^(k+1)) is at most two
+    // below the quotient.
+    std::pair<BigInteger, BigInteger> barrett(const BigInteger& a) const {
+        BigInteger q = a;
+        q.dropLimbs(limbs - 1);
+        q = q * inverse;
+        q.dropLimbs(limbs + 1);
+        BigInteger r = a;
+        r -= q * scaled;
+        while (r >= magnitude) {
+            r -= magnitude;
+            q += 1;
+        }
+        return {q, r};
+    }
+
+    // Long division with B^k as the digit: each step divides (remainder, next k limbs) < |d| * B^k.
+    std::pair<BigInteger, BigInteger> blockDivMod(const BigInteger& a) const {
+        if (a.digits.size() <= 2 * limbs) {
+            return barrett(a);
+        }
+        const std::vector<long long>& source = a.digits;
+        BigInteger div;
+        std::vector<long long>& quotient = div.digits;
+        quotient.assign(source.size(), 0);
+        BigInteger rest;
+        for (size_t end = source.size(); end > 0;) {
+            size_t begin = end > limbs ? end - limbs : 0;
+            BigInteger current;
+            std::vector<long long>& current_limbs = current.digits;
+            current_limbs.assign(source.begin() + static_cast<std::ptrdiff_t>(begin),
+                                 source.begin() + static_cast<std::ptrdiff_t>(end));
+            if (rest) {
+                const std::vector<long long>& high = rest.digits;
+                current_limbs.insert(current_limbs.end(), high.begin(), high.end());
+            }
+            current.deleteZeroes();
+            auto [q, r] = barrett(current);
+            const std::vector<long long>& block = q.digits;
+            std::copy(block.begin(), block.end(), quotient.begin() + static_cast<std::ptrdiff_t>(begin));
+            rest = std::move(r);
+            end = begin;
+        }
+        return {div, rest};
+    }
+#endif
+};
+
+// a / b when b is known to divide a; the result is unspecified otherwise. With b = 2^i * 5^j * m and m coprime to
+// the base, both operands are multiplied once by 5^i * 2^j, which turns 2^i * 5^j into a power of ten that shifts
+// out, and the quotient by m is computed from the low limbs up with no remainder to track.
+BigInteger divexact(const BigInteger& a, const BigInteger& b) {
+    if (!b) {
+        throw std::domain_error("divexact: division by zero");
+    }
+    BIGINTEGER_PROFILE(DivMod, a.size() + b.size());
+#ifdef BIGINTEGER_USE_GMP
+    BigInteger quotient;
+    mpz_divexact(quotient.raw(), a.raw(), b.raw());
+    return quotient;
+#else
+    BigInteger x = a;
+    BigInteger y = b;
+    x.applyAbs();
+    y.applyAbs();
+    size_t zeros = 0;
+    while (y.digits[zeros] == 0) {
+        ++zeros;
+    }
+    x.dropLimbs(zeros);
+    y.dropLimbs(zeros);
+
+    size_t twos = BigInteger::valuation(y, 2);
+    size_t fives = BigInteger::valuation(y, 5);
+    size_t shift = twos + fives;
+    if (shift != 0) {
+        size_t pad = (BigInteger::DIGIT_SIZE - shift % BigInteger::DIGIT_SIZE) % BigInteger::DIGIT_SIZE;
+        BigInteger scale = 1;
+        scale.multiply_pow10(pad);
+        for (size_t done = 0; done < twos; done += BigInteger::POWER_STEP) {
+            scale.multiply(BigInteger::pow5Small(std::min(BigInteger::POWER_STEP, twos - done)));
+        }
+        for (size_t done = 0; done < fives; done += BigInteger::POWER_STEP) {
+            scale.multiply(1LL << std::min(BigInteger::POWER_STEP, fives - done));
+        }
+        x *= scale;
+        x.dropLimbs((shift + pad) / BigInteger::DIGIT_SIZE);
+        y *= scale;
+        y.dropLimbs((shift + pad) / BigInteger::DIGIT_SIZE);
+    }
+
+    BigInteger quotient = x < y ? BigInteger() : BigInteger::henselQuotient(x, y);
+    if (a.is_negative != b.is_negative) {
+        quotient.changeSign();
+    }
+    return quotient;
+#endif
+}
+
+class ContinuedFraction {
+private:
+    static const size_t LEHMER_LIMBS = 5;
+    static const size_t WORD_LIMBS = 6;
+
+    BigInteger a;
+    BigInteger b;
+    std::vector<BigInteger> pending;
+    size_t position = 0;
+
+#ifndef BIGINTEGER_USE_GMP
+    static long long leading(const BigInteger& v, size_t shift, size_t count) {
+        long long value = 0;
+        for (size_t i = std::min(v.digits.size(), shift + count); i-- > shift;) {
+            value = value * BigInteger::REAL_BASE + v.digits[i];
+        }
+        return value;
+    }
+#endif
+
+    static BigInteger combine(const BigInteger& x, long long p, const BigInteger& y, long long q) {
+        BigInteger result;
+        for (auto [v, factor] : {std::pair{&x, p}, std::pair{&y, q}}) {
+            if (factor < 0) {
+                submul_ui(result, *v, static_cast<unsigned long long>(-factor));
+            } else {
+                addmul_ui(result, *v, static_cast<unsigned long long>(factor));
+            }
+        }
+        return result;
+    }
+
+    void divide() {
+        auto [div, mod] = a.div_mod(b);
+        pending.push_back(std::move(div));
+        a = std::exchange(b, std::move(mod));
+    }
+
+    // The GMP backend takes one quotient per refill, as mpz division is linear when the quotient is short.
+    void refill() {
+        pending.clear();
+        position = 0;
+#ifdef BIGINTEGER_USE_GMP
+        divide();
+#else
+        size_t n = a.digits.size();
+        if (n <= WORD_LIMBS) {
+            long long x = leading(a, 0, n);
+            long long y = leading(b, 0, n);
+            while (y) {
+                pending.emplace_back(x / y);
+                x = std::exchange(y, x % y);
+            }
+            a = x;
+            b = 0;
+            return;
+        }
+
+        size_t shift = n - LEHMER_LIMBS;
+        long long x = leading(a, shift, LEHMER_LIMBS);
+        long long y = leading(b, shift, LEHMER_LIMBS);
+        long long A = 1, B = 0, C = 0, D = 1;
+        while (y + C != 0 && y + D != 0) {
+            long long q = (x + A) / (y + C);
+            if (q != (x + B) / (y + D)) {
+                break;
+            }
+            pending.emplace_back(q);
+            A = std::exchange(C, A - q * C);
+            B = std::exchange(D, B - q * D);
+            x = std::exchange(y, x - q * y);
+        }
+        if (pending.empty()) {
+            divide();
+            return;
+        }
+        BigInteger next_a = combine(a, A, b, B);
+        b = combine(a, C, b, D);
+        a = std::move(next_a);
+#endif
+    }
+
+public:
+    class iterator {
+    private:
+        ContinuedFraction* source;
+        BigInteger current;
+
+    public:
+        using value_type = BigInteger;
+        using difference_type = std::ptrdiff_t;
+
+        iterator() : source(nullptr) {}
+        explicit iterator(ContinuedFraction& source) : source(&source) {
+            ++*this;
+        }
+
+        const BigInteger& operator*() const {
+            return current;
+        }
+        iterator& operator++() {
+            if (source->done()) {
+                source = nullptr;
+            } else {
+                current = source->next();
+            }
+            return *this;
+        }
+        void operator++(int) {
+            ++*this;
+        }
+        bool operator==(std::default_sentinel_t) const {
+            return source == nullptr;
+        }
+    };
+
+    ContinuedFraction(const BigInteger& numerator, const BigInteger& denominator) {
+        if (!denominator) {
+            throw std::domain_error("ContinuedFraction: zero denominator");
+        }
+        BigInteger n = numerator;
+        a = denominator;
+        if (a < 0) {
+            a.changeSign();
+            n.changeSign();
+        }
+        auto [div, mod] = n.div_mod(a);
+        b = std::move(mod);
+        if (b < 0) {
+            div -= 1;
+            b += a;
+        }
+        pending.push_back(std::move(div));
+    }
+
+    bool done() const {
+        return position == pending.size() && !b;
+    }
+
+    // The last nonzero remainder; once done(), the gcd of numerator and denominator.
+    const BigInteger& remainder() const {
+        return a;
+    }
+
+    BigInteger next() {
+        if (position == pending.size()) {
+            if (!b) {
+                throw std::out_of_range("ContinuedFraction: expansion exhausted");
+            }
+            refill();
+        }
+        return std::move(pending[position++]);
+    }
+
+    iterator begin() {
+        return iterator(*this);
+    }
+    std::default_sentinel_t end() const {
+        return std::default_sentinel;
+    }
+};
+
+BigInteger gcd(BigInteger a, BigInteger b) {
+    BIGINTEGER_PROFILE(Gcd, a.size() + b.size());
+    a.applyAbs();
+    b.applyAbs();
+#ifdef BIGINTEGER_USE_GMP
+    BigInteger g;
+    mpz_gcd(g.raw(), a.raw(), b.raw());
+    return g;
+#else
+    if (!b) {
+        return a;
+    }
+    ContinuedFraction expansion(a, b);
+    while (!expansion.done()) {
+        expansion.next();
+    }
+    return expansion.remainder();
+#endif
+}
+
+class Rational {
+private:
+    static const size_t MANTISSA_SIZE = 20;
+    static constexpr size_t ESTIMATE_LIMBS = 3;
+    static const long long ESTIMATE_DECISIVE_SHIFT = 7;
+    static constexpr long double ESTIMATE_TOLERANCE = 1e-5L;
+
+    BigInteger x;
+    BigInteger y;
+
+    struct Magnitude {
+        long double mantissa;
+        long long shift;
+    };
+
+    static Magnitude magnitude(const BigInteger& v) {
+#ifdef BIGINTEGER_USE_GMP
+        if (!v) {
+            return {0, 0};
+        }
+        long exponent = 0;
+        double top = std::fabs(mpz_get_d_2exp(&exponent, v.raw()));
+        long double base = BigInteger::REAL_BASE;
+        long double limbs = (std::log10(static_cast<long double>(top)) +
+                             static_cast<long double>(exponent) * std::log10(2.0L)) / BigInteger::DIGIT_SIZE;
+        auto shift = std::max(0LL, static_cast<long long>(limbs) - static_cast<long long>(ESTIMATE_LIMBS) + 1);
+        return {std::pow(base, limbs - static_cast<long double>(shift)), shift};
+#else
+        size_t size = v.digits.size();
+        size_t top = std::min(ESTIMATE_LIMBS, size);
+        long double mantissa = 0;
+        for (size_t i = size; i-- > size - top;) {
+            mantissa = mantissa * BigInteger::REAL_BASE + static_cast<long double>(v.digits[i]);
+        }
+        return {mantissa, static_cast<long long>(size - top)};
+#endif
+    }
+    static Magnitude magnitude(unsigned long long v) {
+        long long shift = 0;
+        for (; v >= 1000000000; v /= BigInteger::REAL_BASE) {
+            ++shift;
+        }
+        return {static_cast<long double>(v), shift};
+    }
+
+    // Returns {p0, q0, p1, q1}: p1/q1 is the last convergent with q1 <= bound, p0/q0 the one before it.
+    std::array<BigInteger, 4> convergentsWithin(const BigInteger& bound) const {
+        if (bound < 1) {
+            throw std::invalid_argument("Rational: denominator bound must be positive");
+        }
+        BigInteger p0 = 0, q0 = 1, p1 = 1, q1 = 0;
+        ContinuedFraction terms = continued_fraction();
+        while (!terms.done()) {
+            BigInteger term = terms.next();
+            BigInteger q2 = q0;
+            addmul(q2, term, q1);
+            if (q2 > bound) {
+                break;
+            }
+            BigInteger p2 = p0;
+            addmul(p2, term, p1);
+            p0 = std::exchange(p1, std::move(p2));
+            q0 = std::exchange(q1, std::move(q2));
+        }
+        return {p0, q0, p1, q1};
+    }
+
+    static bool isNegative(const BigInteger& v) {
+        return v.negative();
+    }
+    static bool isOne(const BigInteger& v) {
+#ifdef BIGINTEGER_USE_GMP
+        return mpz_cmp_ui(v.raw(), 1) == 0;
+#else
+        return v.digits.size() == 1 && v.digits[0] == 1;
+#endif
+    }
+
+    // Orders a/b against c/d from their leading limbs; unordered when too close to call.
+    static std::partial_ordering estimateOrder(Magnitude a, Magnitude b, Magnitude c, Magnitude d) {
+        long long shift = (a.shift - b.shift) - (c.shift - d.shift);
+        if (shift >= ESTIMATE_DECISIVE_SHIFT) {
+            return std::partial_ordering::greater;
+        }
+        if (shift <= -ESTIMATE_DECISIVE_SHIFT) {
+            return std::partial_ordering::less;
+        }
+        long double ratio = a.mantissa * d.mantissa / (b.mantissa * c.mantissa);
+        for (; shift > 0; --shift) {
+            ratio *= BigInteger::REAL_BASE;
+        }
+        for (; shift < 0; ++shift) {
+            ratio /= BigInteger::REAL_BASE;
+        }
+        if (ratio > 1 + ESTIMATE_TOLERANCE) {
+            return std::partial_ordering::greater;
+        }
+        if (ratio < 1 - ESTIMATE_TOLERANCE) {
+            return std::partial_ordering::less;
+        }
+        return std::partial_ordering::unordered;
+    }
+
+    static std::strong_ordering orientate(std::partial_ordering order, bool negative) {
+        bool greater = (order == std::partial_ordering::greater) != negative;
+        return greater ? std::strong_ordering::greater : std::strong_ordering::less;
+    }
+
+    void reduce() {
+        if (y < 0) {
+            x.changeSign();
+            y.changeSign();
+        }
+        BIGINTEGER_PROFILE(Reduce, x.size() + y.size());
+        BigInteger g = gcd(x, y);
+        x = divexact(x, g);
+        y = divexact(y, g);
+    }
+public:
+    Rational(const BigInteger& x): x(x), y(1) {}
+    Rational(const BigInteger& x, const BigInteger& y): x(x), y(y) {
+        reduce();
+    }
+
+    Rational(long long x) : x(x), y(1) {}
+    Rational(long long x, long long y) : x(x), y(y) {
+        reduce();
+    }
+    Rational() : x(0), y(1) {}
+
+    const BigInteger& numerator() const {
+        return x;
+    }
+    const BigInteger& denominator() const {
+        return y;
+    }
+
+    static Rational from_double(double value) {
+        if (!std::isfinite(value)) {
+            throw std::invalid_argument("Rational::from_double: value is not finite");
+        }
+        const int digits = std::numeric_limits<double>::digits;
+        int exponent = 0;
+        auto mantissa = static_cast<long long>(std::ldexp(std::frexp(value, &exponent), digits));
+        exponent -= digits;
+        BigInteger power = 1;
+        for (int rest = std::abs(exponent); rest > 0; rest -= 30) {
+            power.multiply(1LL << std::min(rest, 30));
+        }
+        if (exponent >= 0) {
+            return Rational(power * mantissa);
+        }
+        return Rational(BigInteger(mantissa), power);
+    }
+
+    ContinuedFraction continued_fraction() const {
+        return ContinuedFraction(x, y);
+    }
+
+    // The last convergent with denominator at most max_denominator: it minimizes |q * value - p|.
+    Rational best_approximation(const BigInteger& max_denominator) const {
+        if (y <= max_denominator) {
+            return *this;
+        }
+        auto [p0, q0, p1, q1] = convergentsWithin(max_denominator);
+        return Rational(p1, q1);
+    }
+
+    // The closest fraction with denominator at most max_denominator.
+    Rational limit_denominator(const BigInteger& max_denominator) const {
+        if (y <= max_denominator) {
+            return *this;
+        }
+        auto [p0, q0, p1, q1] = convergentsWithin(max_denominator);
+        BigInteger k = (max_denominator - q0) / q1;
+        addmul(p0, k, p1);
+        addmul(q0, k, q1);
+        Rational semiconvergent(p0, q0);
+        Rational convergent(p1, q1);
+        auto distance = [this](const Rational& r) {
+            Rational d = r;
+            d -= *this;
+            return d < 0 ? -d : d;
+        };
+        return distance(convergent) <= distance(semiconvergent) ? convergent : semiconvergent;
+    }
+
+    explicit operator double() const {
+        return atof(asDecimal(MANTISSA_SIZE).c_str());
+    }
+
+    Rational operator+() const {
+        return *this;
+    }
+    Rational operator-() const {
+        Rational copy(*this);
+        copy.x.changeSign();
+        return copy;
+    }
+
+    Rational& operator+=(const Rational& t) {
+        if (&t == this) {
+            return *this += Rational(t);
+        }
+        x *= t.y;
+        addmul(x, t.x, y);
+        y *= t.y;
+        reduce();
+        return *this;
+    }
+    Rational& operator-=(const Rational& t) {
+        if (&t == this) {
+            return *this -= Rational(t);
+        }
+        x.changeSign();
+        *this += t;
+        x.changeSign();
+        return *this;
+    }
+
+    Rational& operator*=(const Rational& t) {
+        x *= t.x;
+        y *= t.y;
+        reduce();
+        return *this;
+    }
+    Rational& operator/=(const Rational& t) {
+        x *= t.y;
+        y *= t.x;
+        reduce();
+        return *this;
+    }
+
+    bool operator==(const Rational&) const = default;
+    friend std::strong_ordering operator<=>(const Rational& a, const Rational& b) {
+        bool negative = isNegative(a.x);
+        if (negative != isNegative(b.x) || !a.x || !b.x || a.y == b.y) {
+            return a.x <=> b.x;
+        }
+        auto order = estimateOrder(magnitude(a.x), magnitude(a.y), magnitude(b.x), magnitude(b.y));
+        if (order != std::partial_ordering::unordered) {
+            return orientate(order, negative);
+        }
+        return a.x * b.y <=> b.x * a.y;
+    }
+    friend std::strong_ordering operator<=>(const Rational& a, const BigInteger& b) {
+        bool negative = isNegative(a.x);
+        if (negative != isNegative(b) || !a.x || !b || isOne(a.y)) {
+            return a.x <=> b;
+        }
+        auto order = estimateOrder(magnitude(a.x), magnitude(a.y), magnitude(b), magnitude(1ull));
+        if (order != std::partial_ordering::unordered) {
+            return orientate(order, negative);
+        }
+        return a.x <=> b * a.y;
+    }
+    friend std::strong_ordering operator<=>(const Rational& a, long long b) {
+        bool negative = isNegative(a.x);
+        if (negative != (b < 0)) {
+            return negative ? std::strong_ordering::less : std::strong_ordering::greater;
+        }
+        if (!a.x || b == 0) {
+            return a.x ? std::strong_ordering::greater : 0 <=> b;
+        }
+        auto absolute = b < 0 ? 0ull - static_cast<unsigned long long>(b) : static_cast<unsigned long long>(b);
+        auto order = estimateOrder(magnitude(a.x), magnitude(a.y), magnitude(absolute), magnitude(1ull));
+        if (order != std::partial_ordering::unordered) {
+            return orientate(order, negative);
+        }
+        return a.x <=> BigInteger(b) * a.y;
+    }
+    friend bool operator==(const Rational& a, const BigInteger& b) {
+        return isOne(a.y) && a.x == b;
+    }
+    friend bool operator==(const Rational& a, long long b) {
+        return (a <=> b) == 0;
+    }
+
+    uint64_t hash(uint64_t seed = 0) const {
+        return BigInteger::hashMix(x.hash(seed) ^ (y.hash(~seed) << 1));
+    }
+
+    std::string toString() const {
+        return x.toString() + (y != 1_bi ? '/' + y.toString() : "");
+    }
+
+    std::string asDecimal(size_t precision=0) const {
+        Divisor denominator(y);
+        auto [div, mod] = denominator.div_mod(x);
+        std::string integer = div.toString();
+        if (precision == 0) {
+            return integer;
+        }
+        mod.applyAbs();
+        mod.multiply_pow10(precision);
+        mod = denominator.div(mod);
+        std::string s = mod.toString();
+        if (integer == "0" && x < 0 && mod) {
+            integer = "-0";
+        }
+        return integer + '.' + std::string(precision - s.size(), '0') + s;
+    }
+};
+
+Rational operator+(Rational a, const Rational& b) {
+    a += b;
+    return a;
+}
+Rational operator-(Rational a, const Rational& b) {
+    a -= b;
+    return a;
+}
+Rational operator*(Rational a, const Rational& b) {
+    a *= b;
+    return a;
+}
+Rational operator/(Rational a, const Rational& b) {
+    a /= b;
+    return a;
+}
+
+uint64_t default_hash_seed() {
+#ifdef BIGINTEGER_RANDOM_HASH_SEED
+    static const uint64_t seed = uint64_t(std::random_device{}()) << 32 | std::random_device{}();
+    return seed;
+#else
+    return 0;
+#endif
+}
+
+template <>
+struct std::hash<BigInteger> {
+    size_t operator()(const BigInteger& x) const noexcept {
+        return x.hash(default_hash_seed());
+    }
+};
+
+template <>
+struct std::hash<Rational> {
+    size_t operator()(const Rational& x) const noexcept {
+        return x.hash(default_hash_seed());
+    }
+};
+
+template <typename T>
+class Hashed {
+private:
+    T key;
+    size_t hash_value;
+
+public:
+    explicit Hashed(T key) : key(std::move(key)), hash_value(std::hash<T>{}(this->key)) {}
+
+    const T& value() const {
+        return key;
+    }
+    size_t hash() const {
+        return hash_value;
+    }
+
+    bool operator==(const Hashed& x) const {
+        return hash_value == x.hash_value && key == x.key;
+    }
+};
+
+template <typename T>
+struct std::hash<Hashed<T>> {
+    size_t operator()(const Hashed<T>& x) const noexcept {
+        return x.hash();
+    }
+};
+
+namespace {
+    // A thread count of 0 asks for one thread per hardware thread.
+    unsigned threadCount(unsigned threads) {
+        return threads == 0 ? std::max(1u, std::thread::hardware_concurrency()) : threads;
+    }
+
+    // Runs body(t) for every t < count on its own thread and joins them all before rethrowing the first exception
+    // a worker let escape. When a thread fails to start, abandon(missing) hears how many never will, so the started
+    // ones can be released, and the launch error propagates once they are joined.
+    template <typename Body, typename Abandon>
+    void runWorkers(size_t count, Body body, Abandon abandon) {
+        std::vector<std::exception_ptr> errors(count);
+        std::vector<std::thread> workers;
+        workers.reserve(count);
+        auto joinAll = [&workers]() {
+            for (auto& worker : workers) {
+                worker.join();
+            }
+        };
+        try {
+            for (size_t t = 0; t < count; ++t) {
+                workers.emplace_back([&body, &errors, t]() {
+                    try {
+                        body(t);
+                    } catch (...) {
+                        errors[t] = std::current_exception();
+                    }
+                });
+            }
+        } catch (...) {
+            abandon(count - workers.size());
+            joinAll();
+            throw;
+        }
+        joinAll();
+        for (const auto& error : errors) {
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
+    }
+
+    template <typename Body>
+    void parallelFor(size_t count, unsigned threads, Body body) {
+        size_t workers_count = std::min<size_t>(threadCount(threads), count);
+        if (workers_count <= 1) {
+            body(size_t(0), count);
+            return;
+        }
+        runWorkers(workers_count, [&body, count, workers_count](size_t t) {
+            body(count * t / workers_count, count * (t + 1) / workers_count);
+        }, [](size_t) {});
+    }
+
+    uint64_t powMod(uint64_t base, uint64_t exponent, uint64_t mod) {
+        uint64_t result = 1 % mod;
+        base %= mod;
+        while (exponent) {
+            if (exponent & 1) {
+                result = result * base % mod;
+            }
+            base = base * base % mod;
+            exponent >>= 1;
+        }
+        return result;
+    }
+
+    bool isWordPrime(uint64_t n) {
+        if (n < 2) {
+            return false;
+        }
+        for (uint64_t p : {2u, 3u, 5u, 7u, 11u, 13u}) {
+            if (n % p == 0) {
+                return n == p;
+            }
+        }
+        uint64_t d = n - 1;
+        int s = 0;
+        while (d % 2 == 0) {
+            d /= 2;
+            ++s;
+        }
+        for (uint64_t a : {2u, 7u, 61u}) {
+            uint64_t x = powMod(a, d, n);
+            if (x == 1 || x == n - 1 || a % n == 0) {
+                continue;
+            }
+            bool composite = true;
+            for (int r = 1; r < s && composite; ++r) {
+                x = x * x % n;
+                composite = x != n - 1;
+            }
+            if (composite) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    std::vector<uint64_t> wordPrimes(size_t count) {
+        std::vector<uint64_t> primes;
+        for (uint64_t candidate = (uint64_t(1) << 31) - 1; primes.size() < count; candidate -= 2) {
+            if (isWordPrime(candidate)) {
+                primes.push_back(candidate);
+            }
+        }
+        return primes;
+    }
+}
+
+// g = gcd(a, b) >= 0 with cofactors s, t such that s * a + t * b = g. The cofactor of a is the penultimate
+// convergent denominator of |a| / |b|, whose partial quotients come in Lehmer batches from ContinuedFraction; the
+// other cofactor follows by one exact division.
+std::tuple<BigInteger, BigInteger, BigInteger> gcdext(const BigInteger& a, const BigInteger& b) {
+    BIGINTEGER_PROFILE(Gcd, a.size() + b.size());
+    BigInteger x = a;
+    BigInteger y = b;
+    x.applyAbs();
+    y.applyAbs();
+    if (!y) {
+        return {x, a < 0 ? -1 : a > 0 ? 1 : 0, 0};
+    }
+
+    ContinuedFraction expansion(x, y);
+    BigInteger previous = 1;
+    BigInteger current = 0;
+    size_t terms = 0;
+    while (!expansion.done()) {
+        BigInteger term = expansion.next();
+#ifdef BIGINTEGER_USE_GMP
+        addmul(previous, current, term);
+#else
+        if (term.digits.size() <= 6) {
+            unsigned long long factor = 0;
+            for (size_t i = term.digits.size(); i-- > 0;) {
+                factor = factor * BigInteger::REAL_BASE + static_cast<unsigned long long>(term.digits[i]);
+            }
+            addmul_ui(previous, current, factor);
+        } else {
+            addmul(previous, current, term);
+        }
+#endif
+        previous.swap(current);
+        ++terms;
+    }
+
+    BigInteger g = divexact(y, current);
+    BigInteger s = std::move(previous);
+    if (terms % 2 == 1) {
+        s.changeSign();
+    }
+    BigInteger rest = g;
+    submul(rest, s, x);
+    BigInteger t = divexact(rest, y);
+    if (a < 0) {
+        s.changeSign();
+    }
+    if (b < 0) {
+        t.changeSign();
+    }
+    return {g, s, t};
+}
+
+// The inverse of a modulo m > 0, in [0, m).
+BigInteger invmod(const BigInteger& a, const BigInteger& m) {
+    if (m <= 0) {
+        throw std::domain_error("invmod: modulus must be positive");
+    }
+    BigInteger residue = a;
+    if (residue < 0 || residue >= m) {
+        residue = Divisor(m).mod(a);
+        if (residue < 0) {
+            residue += m;
+        }
+    }
+    auto [g, s, t] = gcdext(residue, m);
+    if (g != 1) {
+        throw std::domain_error("invmod: value is not invertible");
+    }
+    if (s < 0) {
+        s += m;
+    }
+    return s;
+}
+
+// Inverses of all values modulo m by Montgomery's trick: one invmod plus about 3n multiplications reduced by a
+// shared Divisor. With several threads, each block of values runs the trick on its own prefix products and the
+// block totals share a single inversion.
+std::vector<BigInteger> batch_invmod(std::span<const BigInteger> values, const BigInteger& m, unsigned threads = 1) {
+    if (m <= 0) {
+        throw std::domain_error("batch_invmod: modulus must be positive");
+    }
+    std::vector<BigInteger> result(values.size());
+    if (values.empty()) {
+        return result;
+    }
+    Divisor modulus(m);
+    auto reduce = [&modulus, &m](const BigInteger& x) {
+        BigInteger residue = modulus.mod(x);
+        if (residue < 0) {
+            residue += m;
+        }
+        return residue;
+    };
+
+    size_t blocks = std::min<size_t>(threadCount(threads), values.size());
+    auto begin = [&values, blocks](size_t block) {
+        return values.size() * block / blocks;
+    };
+    std::vector<BigInteger> prefix(values.size());
+    std::vector<BigInteger> totals(blocks);
+    parallelFor(blocks, threads, [&](size_t first, size_t last) {
+        for (size_t block = first; block < last; ++block) {
+            BigInteger product = 1;
+            for (size_t i = begin(block); i < begin(block + 1); ++i) {
+                result[i] = reduce(values[i]);
+                product = reduce(product * result[i]);
+                prefix[i] = product;
+            }
+            totals[block] = std::move(product);
+        }
+    });
+
+    std::vector<BigInteger> total_inverses(blocks);
+    BigInteger inverse = 1;
+    for (size_t block = 0; block < blocks; ++block) {
+        total_inverses[block] = inverse;
+        inverse = reduce(inverse * totals[block]);
+    }
+    inverse = invmod(inverse, m);
+    for (size_t block = blocks; block-- > 0;) {
+        total_inverses[block] = reduce(total_inverses[block] * inverse);
+        inverse = reduce(inverse * totals[block]);
+    }
+
+    parallelFor(blocks, threads, [&](size_t first, size_t last) {
+        for (size_t block = first; block < last; ++block) {
+            BigInteger inverse = std::move(total_inverses[block]);
+            for (size_t i = begin(block + 1); i-- > begin(block) + 1;) {
+                BigInteger value = std::move(result[i]);
+                result[i] = reduce(inverse * prefix[i - 1]);
+                inverse = reduce(inverse * value);
+            }
+            result[begin(block)] = std::move(inverse);
+        }
+    });
+    return result;
+}
+
+template <typename T>
+class Matrix {
+private:
+    static const size_t BLOCK_SIZE = 32;
+
+    size_t row_count;
+    size_t col_count;
+    std::vector<T> cells;
+
+    void checkSameShape(const Matrix& x) const {
+        if (row_count != x.row_count || col_count != x.col_count) {
+            throw std::invalid_argument("Matrix: shape mismatch");
+        }
+    }
+
+public:
+    Matrix() : row_count(0), col_count(0) {}
+    Matrix(size_t rows, size_t cols) : row_count(rows), col_count(cols), cells(rows * cols) {}
+    Matrix(std::initializer_list<std::initializer_list<T>> rows)
+        : row_count(rows.size())
+        , col_count(rows.size() ? rows.begin()->size() : 0) {
+        cells.reserve(row_count * col_count);
+        for (const auto& row : rows) {
+            if (row.size() != col_count) {
+                throw std::invalid_argument("Matrix: ragged initializer");
+            }
+            cells.insert(cells.end(), row.begin(), row.end());
+        }
+    }
+
+    static Matrix identity(size_t n) {
+        Matrix result(n, n);
+        for (size_t i = 0; i < n; ++i) {
+            result(i, i) = 1;
+        }
+        return result;
+    }
+
+    size_t rows() const {
+        return row_count;
+    }
+    size_t cols() const {
+        return col_count;
+    }
+
+    T& operator()(size_t i, size_t j) {
+        return cells[i * col_count + j];
+    }
+    const T& operator()(size_t i, size_t j) const {
+        return cells[i * col_count + j];
+    }
+
+    void swapRows(size_t a, size_t b) {
+        if (a != b) {
+            std::swap_ranges(cells.begin() + static_cast<std::ptrdiff_t>(a * col_count),
+                             cells.begin() + static_cast<std::ptrdiff_t>((a + 1) * col_count),
+                             cells.begin() + static_cast<std::ptrdiff_t>(b * col_count));
+        }
+    }
+
+    bool operator==(const Matrix&) const = default;
+
+    Matrix& operator+=(const Matrix& x) {
+        checkSameShape(x);
+        for (size_t i = 0; i < cells.size(); ++i) {
+            cells[i] += x.cells[i];
+        }
+        return *this;
+    }
+    Matrix& operator-=(const Matrix& x) {
+        checkSameShape(x);
+        for (size_t i = 0; i < cells.size(); ++i) {
+            cells[i] -= x.cells[i];
+        }
+        return *this;
+    }
+    Matrix& operator*=(const Matrix& x) {
+        return *this = multiply(*this, x);
+    }
+
+    friend Matrix multiply(const Matrix& a, const Matrix& b, unsigned threads = 1) {
+        if (a.col_count != b.row_count) {
+            throw std::invalid_argument("Matrix: shape mismatch");
+        }
+        Matrix c(a.row_count, b.col_count);
+        size_t row_blocks = (a.row_count + BLOCK_SIZE - 1) / BLOCK_SIZE;
+        parallelFor(row_blocks, threads, [&a, &b, &c](size_t first, size_t last) {
+            for (size_t ii = first * BLOCK_SIZE; ii < std::min(last * BLOCK_SIZE, a.row_count); ii += BLOCK_SIZE) {
+                size_t i_end = std::min(ii + BLOCK_SIZE, a.row_count);
+                for (size_t kk = 0; kk < a.col_count; kk += BLOCK_SIZE) {
+                    size_t k_end = std::min(kk + BLOCK_SIZE, a.col_count);
+                    for (size_t jj = 0; jj < b.col_count; jj += BLOCK_SIZE) {
+                        size_t j_end = std::min(jj + BLOCK_SIZE, b.col_count);
+                        for (size_t i = ii; i < i_end; ++i) {
+                            for (size_t k = kk; k < k_end; ++k) {
+                                const T& left = a(i, k);
+                                if (left == T(0)) {
+                                    continue;
+                                }
+                                for (size_t j = jj; j < j_end; ++j) {
+                                    if constexpr (std::is_same_v<T, BigInteger>) {
+                                        addmul(c(i, j), left, b(k, j));
+                                    } else {
+                                        c(i, j) += left * b(k, j);
+                                    }
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+        });
+        return c;
+    }
+};
+
+template <typename T>
+Matrix<T> operator+(Matrix<T> a, const Matrix<T>& b) {
+    a += b;
+    return a;
+}
+template <typename T>
+Matrix<T> operator-(Matrix<T> a, const Matrix<T>& b) {
+    a -= b;
+    return a;
+}
+template <typename T>
+Matrix<T> operator*(const Matrix<T>& a, const Matrix<T>& b) {
+    return multiply(a, b);
+}
+
+namespace {
+    // Systems from MODULAR_ELIMINATION_SIZE rows, plus one per MODULAR_ELIMINATION_LIMBS limbs of the largest
+    // entry, are solved from residues modulo word primes instead of by Bareiss elimination.
+    const size_t MODULAR_ELIMINATION_SIZE = 6;
+    const size_t MODULAR_ELIMINATION_LIMBS = 20;
+
+    // Fraction-free elimination of the first pivots columns; returns the sign of the row permutation, or 0 when a
+    // pivot column is zero. With several threads the rows below the pivot are dealt out cyclically to workers that
+    // live for the whole elimination and meet at a barrier after each step. A worker that throws drops out of the
+    // barrier and the next step ends the elimination for the others, so the error reaches the caller.
+    int bareissEliminate(Matrix<BigInteger>& m, size_t pivots, unsigned threads) {
+        int sign = 1;
+        size_t k = 0;
+        BigInteger previous = 1;
+        auto choosePivot = [&m, &sign, &k]() {
+            size_t pivot = k;
+            while (pivot < m.rows() && !m(pivot, k)) {
+                ++pivot;
+            }
+            if (pivot == m.rows()) {
+                return false;
+            }
+            if (pivot != k) {
+                m.swapRows(pivot, k);
+                sign = -sign;
+            }
+            return true;
+        };
+        auto eliminateRow = [&m, &previous, &k](size_t i) {
+            for (size_t j = k + 1; j < m.cols(); ++j) {
+                m(i, j) *= m(k, k);
+                submul(m(i, j), m(i, k), m(k, j));
+                m(i, j) = divexact(m(i, j), previous);
+            }
+            m(i, k) = 0;
+        };
+
+        size_t workers_count = std::min<size_t>(threadCount(threads), m.rows());
+        if (workers_count <= 1) {
+            for (; k < pivots; ++k) {
+                if (!choosePivot()) {
+                    return 0;
+                }
+                for (size_t i = k + 1; i < m.rows(); ++i) {
+                    eliminateRow(i);
+                }
+                previous = m(k, k);
+            }
+            return sign;
+        }
+
+        bool singular = pivots > 0 && !choosePivot();
+        std::atomic<bool> failed = false;
+        std::exception_ptr advance_error;
+        auto advance = [&]() noexcept {
+            if (failed) {
+                k = pivots;
+                return;
+            }
+            try {
+                previous = m(k, k);
+                ++k;
+                singular = k < pivots && !choosePivot();
+            } catch (...) {
+                advance_error = std::current_exception();
+                k = pivots;
+            }
+        };
+        std::barrier step(static_cast<std::ptrdiff_t>(workers_count), advance);
+        runWorkers(workers_count, [&](size_t t) {
+            while (k < pivots && !singular) {
+                try {
+                    for (size_t i = k + 1 + t; i < m.rows(); i += workers_count) {
+                        eliminateRow(i);
+                    }
+                } catch (...) {
+                    failed = true;
+                    step.arrive_and_drop();
+                    throw;
+                }
+                step.arrive_and_wait();
+            }
+        }, [&](size_t missing) {
+            failed = true;
+            while (missing--) {
+                step.arrive_and_drop();
+            }
+        });
+        if (advance_error) {
+            std::rethrow_exception(advance_error);
+        }
+        return singular ? 0 : sign;
+    }
+
+    // Reduces the first rows() columns of m modulo p to upper triangular form in a (row-major, m.cols() wide) and
+    // returns det mod p of that square part.
+    uint64_t eliminateModPrime(const Matrix<BigInteger>& m, uint64_t p, std::vector<uint64_t>& a) {
+        size_t n = m.rows();
+        size_t cols = m.cols();
+        a.assign(n * cols, 0);
+        for (size_t i = 0; i < n; ++i) {
+            for (size_t j = 0; j < cols; ++j) {
+                a[i * cols + j] = static_cast<uint64_t>(m(i, j).mod_small(static_cast<long long>(p)));
+            }
+        }
+        // Row updates reduce with a floating-point estimate of the quotient, which is off by at most one.
+        const double inverse_p = 1.0 / static_cast<double>(p);
+        auto reduce = [p, inverse_p](uint64_t x) {
+            auto q = static_cast<uint64_t>(static_cast<double>(x) * inverse_p);
+            auto r = static_cast<int64_t>(x - q * p);
+            if (r < 0) {
+                r += static_cast<int64_t>(p);
+            } else if (r >= static_cast<int64_t>(p)) {
+                r -= static_cast<int64_t>(p);
+            }
+            return static_cast<uint64_t>(r);
+        };
+        uint64_t det = 1;
+        for (size_t k = 0; k < n; ++k) {
+            size_t pivot = k;
+            while (pivot < n && a[pivot * cols + k] == 0) {
+                ++pivot;
+            }
+            if (pivot == n) {
+                return 0;
+            }
+            if (pivot != k) {
+                std::swap_ranges(a.begin() + static_cast<std::ptrdiff_t>(pivot * cols),
+                                 a.begin() + static_cast<std::ptrdiff_t>((pivot + 1) * cols),
+                                 a.begin() + static_cast<std::ptrdiff_t>(k * cols));
+                det = p - det;
+            }
+            det = det * a[k * cols + k] % p;
+            uint64_t inverse = powMod(a[k * cols + k], p - 2, p);
+            for (size_t i = k + 1; i < n; ++i) {
+                uint64_t factor = a[i * cols + k] * inverse % p;
+                if (factor == 0) {
+                    continue;
+                }
+                for (size_t j = k; j < cols; ++j) {
+                    a[i * cols + j] = reduce(a[i * cols + j] + (p - factor) * a[k * cols + j]);
+                }
+            }
+        }
+        return det % p;
+    }
+
+    uint64_t determinantModPrime(const Matrix<BigInteger>& m, uint64_t p) {
+        std::vector<uint64_t> a;
+        return eliminateModPrime(m, p, a);
+    }
+
+    // For an n x (n + 1) augmented system, the residues modulo p of det * x (the Cramer numerators) followed by
+    // det itself. All zero when det = 0 (mod p).
+    std::vector<uint64_t> solveModPrime(const Matrix<BigInteger>& augmented, uint64_t p) {
+        size_t n = augmented.rows();
+        size_t cols = n + 1;
+        std::vector<uint64_t> a;
+        std::vector<uint64_t> result(n + 1);
+        uint64_t det = eliminateModPrime(augmented, p, a);
+        if (det == 0) {
+            return result;
+        }
+        for (size_t i = n; i-- > 0;) {
+            uint64_t acc = a[i * cols + n];
+            for (size_t j = i + 1; j < n; ++j) {
+                acc = (acc + (p - a[i * cols + j]) * result[j]) % p;
+            }
+            result[i] = acc * powMod(a[i * cols + i], p - 2, p) % p;
+        }
+        for (size_t i = 0; i < n; ++i) {
+            result[i] = result[i] * det % p;
+        }
+        result[n] = det;
+        return result;
+    }
+
+    // Bits of the Hadamard bound on any n x n minor of m, plus a sign bit and a spare one.
+    size_t hadamardBits(const Matrix<BigInteger>& m) {
+        size_t bits = 2;
+        for (size_t i = 0; i < m.rows(); ++i) {
+            std::vector<BigInteger> row(m.cols());
+            for (size_t j = 0; j < m.cols(); ++j) {
+                row[j] = m(i, j);
+            }
+            bits += 5 * dot(row, row).size() + 1;
+        }
+        return bits;
+    }
+
+    // The value in (-M/2, M/2] with the given residues, M being the product of the primes (Garner's method).
+    std::vector<BigInteger> fromResidues(const std::vector<std::vector<uint64_t>>& residues,
+                                         const std::vector<uint64_t>& primes, size_t count) {
+        std::vector<BigInteger> values(count);
+        BigInteger modulus = 1;
+        for (size_t i = 0; i < primes.size(); ++i) {
+            uint64_t p = primes[i];
+            auto inverse = powMod(static_cast<uint64_t>(modulus.mod_small(static_cast<long long>(p))), p - 2, p);
+            for (size_t v = 0; v < count; ++v) {
+                auto current = static_cast<uint64_t>(values[v].mod_small(static_cast<long long>(p)));
+                uint64_t t = (residues[i][v] + p - current) % p * inverse % p;
+                addmul_ui(values[v], modulus, t);
+            }
+            modulus.multiply(static_cast<long long>(p));
+        }
+        for (auto& value : values) {
+            BigInteger twice = value;
+            twice.multiply(2);
+            if (twice > modulus) {
+                value -= modulus;
+            }
+        }
+        return values;
+    }
+
+    void checkSquare(size_t rows, size_t cols) {
+        if (rows != cols) {
+            throw std::invalid_argument("Matrix: square matrix expected");
+        }
+    }
+
+    BigInteger lcm(const BigInteger& a, const BigInteger& b) {
+        return divexact(a, gcd(a, b)) * b;
+    }
+
+    std::pair<Matrix<BigInteger>, BigInteger> clearDenominators(const Matrix<Rational>& m,
+                                                                const std::vector<Rational>& rhs = {}) {
+        Matrix<BigInteger> result(m.rows(), m.cols() + (rhs.empty() ? 0 : 1));
+        BigInteger scale = 1;
+        for (size_t i = 0; i < m.rows(); ++i) {
+            BigInteger row_lcm = rhs.empty() ? BigInteger(1) : rhs[i].denominator();
+            for (size_t j = 0; j < m.cols(); ++j) {
+                row_lcm = lcm(row_lcm, m(i, j).denominator());
+            }
+            for (size_t j = 0; j < m.cols(); ++j) {
+                result(i, j) = m(i, j).numerator() * divexact(row_lcm, m(i, j).denominator());
+            }
+            if (!rhs.empty()) {
+                result(i, m.cols()) = rhs[i].numerator() * divexact(row_lcm, rhs[i].denominator());
+            }
+            scale *= row_lcm;
+        }
+        return {result, scale};
+    }
+
+    std::vector<Rational> backSubstitute(const Matrix<BigInteger>& echelon) {
+        size_t n = echelon.rows();
+        const BigInteger& det = echelon(n - 1, n - 1);
+        std::vector<BigInteger> scaled(n);
+        for (size_t i = n; i-- > 0;) {
+            BigInteger acc = lazy(det) * echelon(i, n);
+            for (size_t j = i + 1; j < n; ++j) {
+                acc -= lazy(echelon(i, j)) * scaled[j];
+            }
+            scaled[i] = divexact(acc, echelon(i, i));
+        }
+        std::vector<Rational> solution;
+        solution.reserve(n);
+        for (const auto& value : scaled) {
+            solution.emplace_back(value, det);
+        }
+        return solution;
+    }
+
+    bool preferResidues(const Matrix<BigInteger>& m) {
+        size_t entry_limbs = 0;
+        for (size_t i = 0; i < m.rows(); ++i) {
+            for (size_t j = 0; j < m.cols(); ++j) {
+                entry_limbs = std::max(entry_limbs, m(i, j).size());
+            }
+        }
+        return m.rows() >= MODULAR_ELIMINATION_SIZE + entry_limbs / MODULAR_ELIMINATION_LIMBS;
+    }
+
+    // Solves a nonempty n x (n + 1) augmented system. Large systems are solved modulo enough word primes to pin
+    // down the Cramer numerators and the determinant; primes dividing the determinant are replaced by further ones,
+    // and the system is singular when the first batch of primes all divide it.
+    std::vector<Rational> solveAugmented(Matrix<BigInteger> augmented, unsigned threads) {
+        size_t n = augmented.rows();
+        if (!preferResidues(augmented)) {
+            if (bareissEliminate(augmented, n, threads) == 0) {
+                throw std::domain_error("solve: singular matrix");
+            }
+            return backSubstitute(augmented);
+        }
+
+        size_t needed = hadamardBits(augmented) / 30 + 1;
+        std::vector<uint64_t> candidates;
+        std::vector<uint64_t> primes;
+        std::vector<std::vector<uint64_t>> residues;
+        while (primes.size() < needed) {
+            size_t start = candidates.size();
+            candidates = wordPrimes(start + needed - primes.size());
+            std::vector<std::vector<uint64_t>> batch(candidates.size() - start);
+            parallelFor(batch.size(), threads, [&augmented, &candidates, &batch, start](size_t first, size_t last) {
+                for (size_t i = first; i < last; ++i) {
+                    batch[i] = solveModPrime(augmented, candidates[start + i]);
+                }
+            });
+            for (size_t i = 0; i < batch.size(); ++i) {
+                if (batch[i][n] != 0) {
+                    primes.push_back(candidates[start + i]);
+                    residues.push_back(std::move(batch[i]));
+                }
+            }
+            if (primes.empty()) {
+                throw std::domain_error("solve: singular matrix");
+            }
+        }
+
+        std::vector<BigInteger> values = fromResidues(residues, primes, n + 1);
+        std::vector<Rational> solution;
+        solution.reserve(n);
+        for (size_t i = 0; i < n; ++i) {
+            solution.emplace_back(values[i], values[n]);
+        }
+        return solution;
+    }
+}
+
+BigInteger determinant_modular(const Matrix<BigInteger>& m, unsigned threads = 1) {
+    checkSquare(m.rows(), m.cols());
+    std::vector<uint64_t> primes = wordPrimes(hadamardBits(m) / 30 + 1);
+    std::vector<std::vector<uint64_t>> residues(primes.size());
+    parallelFor(primes.size(), threads, [&m, &primes, &residues](size_t first, size_t last) {
+        for (size_t i = first; i < last; ++i) {
+            residues[i] = {determinantModPrime(m, primes[i])};
+        }
+    });
+    return std::move(fromResidues(residues, primes, 1)[0]);
+}
+
+BigInteger determinant(const Matrix<BigInteger>& m, unsigned threads = 1) {
+    checkSquare(m.rows(), m.cols());
+    if (m.rows() == 0) {
+        return 1;
+    }
+    if (preferResidues(m)) {
+        return determinant_modular(m, threads);
+    }
+    Matrix<BigInteger> work = m;
+    int sign = bareissEliminate(work, m.rows(), threads);
+    BigInteger det = work(m.rows() - 1, m.rows() - 1);
+    if (sign <= 0) {
+        det = sign == 0 ? BigInteger(0) : -det;
+    }
+    return det;
+}
+
+Rational determinant(const Matrix<Rational>& m, unsigned threads = 1) {
+    auto [integral, scale] = clearDenominators(m);
+    return Rational(determinant(integral, threads), scale);
+}
+
+std::vector<Rational> solve(const Matrix<BigInteger>& a, const std::vector<BigInteger>& b, unsigned threads = 1) {
+    checkSquare(a.rows(), a.cols());
+    if (b.size() != a.rows()) {
+        throw std::invalid_argument("solve: right-hand side size mismatch");
+    }
+    size_t n = a.rows();
+    Matrix<BigInteger> augmented(n, n + 1);
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = 0; j < n; ++j) {
+            augmented(i, j) = a(i, j);
+        }
+        augmented(i, n) = b[i];
+    }
+    if (n == 0) {
+        return {};
+    }
+    return solveAugmented(augmented, threads);
+}
+
+std::vector<Rational> solve(const Matrix<Rational>& a, const std::vector<Rational>& b, unsigned threads = 1) {
+    checkSquare(a.rows(), a.cols());
+    if (b.size() != a.rows()) {
+        throw std::invalid_argument("solve: right-hand side size mismatch");
+    }
+    if (a.rows() == 0) {
+        return {};
+    }
+    return solveAugmented(clearDenominators(a, b).first, threads);
+}
+
+struct Kronecker {
+#ifdef BIGINTEGER_USE_GMP
+    // Slots are whole mpz limbs: packing copies the magnitudes in place and unpacking walks the product once,
+    // carrying a borrow into the next slot whenever a coefficient comes out negative.
+    static size_t slotLimbs(const std::vector<BigInteger>& a, const std::vector<BigInteger>& b) {
+        size_t a_bits = 0;
+        size_t b_bits = 0;
+        for (const auto& x : a) {
+            a_bits = std::max(a_bits, mpz_sizeinbase(x.raw(), 2));
+        }
+        for (const auto& x : b) {
+            b_bits = std::max(b_bits, mpz_sizeinbase(x.raw(), 2));
+        }
+        size_t term_bits = std::bit_width(std::min(a.size(), b.size()));
+        return (a_bits + b_bits + term_bits + 1) / GMP_NUMB_BITS + 1;
+    }
+
+    static BigInteger pack(const std::vector<BigInteger>& coefficients, size_t slot) {
+        size_t size = slot * coefficients.size();
+        mpz_class parts[2];
+        mp_limb_t* limbs[2];
+        for (size_t k = 0; k < 2; ++k) {
+            limbs[k] = mpz_limbs_write(parts[k].get_mpz_t(), static_cast<mp_size_t>(size));
+            std::fill_n(limbs[k], size, 0);
+        }
+        for (size_t i = 0; i < coefficients.size(); ++i) {
+            const BigInteger& c = coefficients[i];
+            std::copy_n(mpz_limbs_read(c.raw()), mpz_size(c.raw()), limbs[c.negative() ? 1 : 0] + slot * i);
+        }
+        for (size_t k = 0; k < 2; ++k) {
+            mpz_limbs_finish(parts[k].get_mpz_t(), static_cast<mp_size_t>(size));
+        }
+        BigInteger packed;
+        mpz_sub(packed.raw(), parts[0].get_mpz_t(), parts[1].get_mpz_t());
+        return packed;
+    }
+
+    static std::vector<BigInteger> unpack(const BigInteger& packed, size_t slot, size_t count) {
+        const mp_limb_t* source = mpz_limbs_read(packed.raw());
+        size_t size = mpz_size(packed.raw());
+        size_t bits = slot * GMP_NUMB_BITS;
+        mpz_class full;
+        mpz_setbit(full.get_mpz_t(), bits);
+        std::vector<BigInteger> result(count);
+        bool borrow = false;
+        for (size_t i = 0; i < count; ++i) {
+            mpz_ptr c = result[i].raw();
+            mp_limb_t* limbs = mpz_limbs_write(c, static_cast<mp_size_t>(slot));
+            std::fill_n(limbs, slot, 0);
+            if (slot * i < size) {
+                std::copy(source + slot * i, source + std::min(size, slot * (i + 1)), limbs);
+            }
+            mpz_limbs_finish(c, static_cast<mp_size_t>(slot));
+            if (borrow) {
+                mpz_add_ui(c, c, 1);
+            }
+            borrow = mpz_sizeinbase(c, 2) >= bits;
+            if (borrow) {
+                mpz_sub(c, c, full.get_mpz_t());
+            }
+            if (packed.negative()) {
+                result[i].changeSign();
+            }
+        }
+        return result;
+    }
+#else
+    static size_t slotLimbs(const std::vector<BigInteger>& a, const std::vector<BigInteger>& b) {
+        size_t a_limbs = 0;
+        size_t b_limbs = 0;
+        for (const auto& x : a) {
+            a_limbs = std::max(a_limbs, x.digits.size());
+        }
+        for (const auto& x : b) {
+            b_limbs = std::max(b_limbs, x.digits.size());
+        }
+        size_t terms = std::min(a.size(), b.size());
+        size_t term_limbs = 1;
+        while (terms >= static_cast<size_t>(BigInteger::REAL_BASE)) {
+            terms /= static_cast<size_t>(BigInteger::REAL_BASE);
+            ++term_limbs;
+        }
+        return a_limbs + b_limbs + term_limbs + 1;
+    }
+
+    static BigInteger pack(const std::vector<BigInteger>& coefficients, size_t slot) {
+        BigInteger packed;
+        packed.digits.assign(slot * coefficients.size() + 1, 0);
+        for (size_t i = 0; i < coefficients.size(); ++i) {
+            const BigInteger& c = coefficients[i];
+            long long sign = c.is_negative ? -1 : 1;
+            for (size_t t = 0; t < c.digits.size(); ++t) {
+                packed.digits[slot * i + t] += sign * c.digits[t];
+            }
+        }
+        packed.normalizeSigned();
+        return packed;
+    }
+
+    static std::vector<BigInteger> unpack(const BigInteger& packed, size_t slot, size_t count) {
+        const long long half = BigInteger::REAL_BASE / 2;
+        std::vector<BigInteger> result(count);
+        long long carry = 0;
+        for (size_t i = 0; i < count; ++i) {
+            std::vector<long long>& limbs = result[i].digits;
+            limbs.assign(slot, 0);
+            for (size_t t = 0; t < slot && slot * i + t < packed.digits.size(); ++t) {
+                limbs[t] = packed.digits[slot * i + t];
+            }
+            for (size_t t = 0; carry && t < slot; ++t) {
+                limbs[t] += carry;
+                carry = limbs[t] / BigInteger::REAL_BASE;
+                limbs[t] %= BigInteger::REAL_BASE;
+            }
+            bool negative = false;
+            if (carry == 0 && limbs[slot - 1] >= half) {
+                for (auto& limb : limbs) {
+                    limb = BigInteger::REAL_BASE - 1 - limb;
+                }
+                for (size_t t = 0; t < slot && ++limbs[t] == BigInteger::REAL_BASE; ++t) {
+                    limbs[t] = 0;
+                }
+                negative = true;
+                carry = 1;
+            }
+            result[i].is_negative = negative != packed.is_negative;
+            result[i].deleteZeroes();
+        }
+        return result;
+    }
+#endif
+
+    static std::vector<BigInteger> multiply(const std::vector<BigInteger>& a, const std::vector<BigInteger>& b) {
+        if (a.empty() || b.empty()) {
+            return {};
+        }
+        size_t slot = slotLimbs(a, b);
+        BigInteger product = pack(a, slot);
+        product *= pack(b, slot);
+        return unpack(product, slot, a.size() + b.size() - 1);
+    }
+};
+
+// Dense polynomial over BigInteger or Rational, lowest coefficient first. Over BigInteger, division by a divisor
+// whose leading coefficient is not 1 or -1 stays in Z[x]: div_mod, / and % throw std::domain_error when a quotient
+// coefficient is not an integer, even if the rational quotient exists. Use Polynomial<Rational> for those.
+template <typename T>
+class Polynomial {
+    static_assert(std::is_same_v<T, BigInteger> || std::is_same_v<T, Rational>,
+                  "Polynomial coefficients must be BigInteger or Rational");
+
+private:
+    static const size_t FAST_DIVISION_THRESHOLD = 32;
+    static const size_t MULTIPOINT_THRESHOLD = 16;
+
+    std::vector<T> coeffs;
+
+    void normalize() {
+        while (!coeffs.empty() && coeffs.back() == T(0)) {
+            coeffs.pop_back();
+        }
+    }
+
+    static T divideExact(const T& a, const T& b) {
+        if constexpr (std::is_same_v<T, BigInteger>) {
+            auto [div, mod] = a.div_mod(b);
+            if (mod) {
+                throw std::domain_error("Polynomial: inexact coefficient division");
+            }
+            return div;
+        } else {
+            return a / b;
+        }
+    }
+
+    static std::vector<BigInteger> toIntegral(const std::vector<T>& values, BigInteger& scale) {
+        if constexpr (std::is_same_v<T, Rational>) {
+            scale = 1;
+            for (const auto& value : values) {
+                scale = scale / gcd(scale, value.denominator()) * value.denominator();
             }
+            std::vector<BigInteger> result;
+            result.reserve(values.size());
+            for (const auto& value : values) {
+                result.push_back(value.numerator() * (scale / value.denominator()));
+            }
+            return result;
         } else {
-            if (x.digits.size() >= digits.size()) {
-                digits.resize(x.digits.size());
-                size_t i = x.digits.size() - 1;
-                for (; i > 0 && digits[i] == x.digits[i]; --i) {
-                    digits.pop_back();
-                }
-                is_negative ^= digits[i] < x.digits[i];
+            scale = 1;
+            return values;
+        }
+    }
+
+    Polynomial truncated(size_t n) const {
+        Polynomial result = *this;
+        if (result.coeffs.size() > n) {
+            result.coeffs.resize(n);
+            result.normalize();
+        }
+        return result;
+    }
+
+    Polynomial reversed(size_t n) const {
+        Polynomial result;
+        result.coeffs.assign(n, T(0));
+        for (size_t i = 0; i < coeffs.size() && i < n; ++i) {
+            result.coeffs[n - 1 - i] = coeffs[i];
+        }
+        result.normalize();
+        return result;
+    }
+
+    static Polynomial inverseSeries(const Polynomial& g, size_t n) {
+        Polynomial h(T(1));
+        for (size_t k = 1; k < n;) {
+            k = std::min(2 * k, n);
+            Polynomial correction = (g.truncated(k) * h).truncated(k);
+            correction = Polynomial(T(2)) - correction;
+            h = (h * correction).truncated(k);
+        }
+        return h;
+    }
+
+    std::pair<Polynomial, Polynomial> schoolbookDivMod(const Polynomial& g) const {
+        std::vector<T> rest = coeffs;
+        size_t dg = g.coeffs.size() - 1;
+        std::vector<T> quotient(coeffs.size() - dg);
+        for (size_t i = quotient.size(); i-- > 0;) {
+            if (rest[i + dg] == T(0)) {
+                continue;
             }
+            quotient[i] = divideExact(rest[i + dg], g.coeffs.back());
+            for (size_t j = 0; j <= dg; ++j) {
+                rest[i + j] -= quotient[i] * g.coeffs[j];
+            }
+        }
+        rest.resize(dg);
+        return {Polynomial(std::move(quotient)), Polynomial(std::move(rest))};
+    }
 
-            long long carry = 0;
-            long long sign = 1 - 2 * (is_negative == x.is_negative);
-            for (size_t i = 0; i < x.digits.size(); ++i) {
-                digits[i] = sign * (digits[i] - x.digits[i]) - carry;
-                carry = digits[i] < 0;
-                if (carry) {
-                    digits[i] += REAL_BASE;
+    std::pair<Polynomial, Polynomial> monicDivMod(const Polynomial& g) const {
+        size_t quotient_size = coeffs.size() - g.coeffs.size() + 1;
+        if (g.coeffs.size() < FAST_DIVISION_THRESHOLD || quotient_size < FAST_DIVISION_THRESHOLD) {
+            return schoolbookDivMod(g);
+        }
+        Polynomial inverse = inverseSeries(g.reversed(g.coeffs.size()), quotient_size);
+        Polynomial quotient = (reversed(coeffs.size()) * inverse).truncated(quotient_size).reversed(quotient_size);
+        Polynomial rest = *this - quotient * g;
+        return {quotient, rest};
+    }
+
+public:
+    Polynomial() = default;
+    Polynomial(const T& constant) : coeffs{constant} {
+        normalize();
+    }
+    Polynomial(std::initializer_list<T> values) : coeffs(values) {
+        normalize();
+    }
+    explicit Polynomial(std::vector<T> values) : coeffs(std::move(values)) {
+        normalize();
+    }
+
+    static Polynomial monomial(const T& coefficient, size_t power) {
+        std::vector<T> values(power + 1);
+        values[power] = coefficient;
+        return Polynomial(std::move(values));
+    }
+
+    long long degree() const {
+        return static_cast<long long>(coeffs.size()) - 1;
+    }
+    const std::vector<T>& coefficients() const {
+        return coeffs;
+    }
+    T operator[](size_t i) const {
+        return i < coeffs.size() ? coeffs[i] : T(0);
+    }
+    const T& leading() const {
+        return coeffs.back();
+    }
+    explicit operator bool() const {
+        return !coeffs.empty();
+    }
+
+    bool operator==(const Polynomial&) const = default;
+
+    Polynomial operator+() const {
+        return *this;
+    }
+    Polynomial operator-() const {
+        Polynomial copy = *this;
+        for (auto& c : copy.coeffs) {
+            c = -c;
+        }
+        return copy;
+    }
+
+    Polynomial& operator+=(const Polynomial& p) {
+        if (coeffs.size() < p.coeffs.size()) {
+            coeffs.resize(p.coeffs.size());
+        }
+        for (size_t i = 0; i < p.coeffs.size(); ++i) {
+            coeffs[i] += p.coeffs[i];
+        }
+        normalize();
+        return *this;
+    }
+    Polynomial& operator-=(const Polynomial& p) {
+        if (coeffs.size() < p.coeffs.size()) {
+            coeffs.resize(p.coeffs.size());
+        }
+        for (size_t i = 0; i < p.coeffs.size(); ++i) {
+            coeffs[i] -= p.coeffs[i];
+        }
+        normalize();
+        return *this;
+    }
+
+    Polynomial& operator*=(const Polynomial& p) {
+        if (coeffs.empty() || p.coeffs.empty()) {
+            coeffs.clear();
+            return *this;
+        }
+        BigInteger left_scale;
+        BigInteger right_scale;
+        std::vector<BigInteger> product = Kronecker::multiply(toIntegral(coeffs, left_scale),
+                                                              toIntegral(p.coeffs, right_scale));
+        if constexpr (std::is_same_v<T, BigInteger>) {
+            coeffs = std::move(product);
+        } else {
+            BigInteger scale = left_scale * right_scale;
+            coeffs.assign(product.size(), T(0));
+            for (size_t i = 0; i < product.size(); ++i) {
+                coeffs[i] = Rational(product[i], scale);
+            }
+        }
+        normalize();
+        return *this;
+    }
+
+    std::pair<Polynomial, Polynomial> div_mod(const Polynomial& g) const {
+        if (g.coeffs.empty()) {
+            throw std::domain_error("Polynomial: division by zero");
+        }
+        if (coeffs.size() < g.coeffs.size()) {
+            return {Polynomial(), *this};
+        }
+        if (g.leading() == T(1)) {
+            return monicDivMod(g);
+        }
+        if (g.leading() == T(-1)) {
+            auto [div, mod] = monicDivMod(-g);
+            return {-div, mod};
+        }
+        if constexpr (std::is_same_v<T, BigInteger>) {
+            return schoolbookDivMod(g);
+        } else {
+            T inverse = T(1) / g.leading();
+            Polynomial monic = g;
+            for (auto& c : monic.coeffs) {
+                c *= inverse;
+            }
+            auto [div, mod] = monicDivMod(monic);
+            for (auto& c : div.coeffs) {
+                c *= inverse;
+            }
+            return {div, mod};
+        }
+    }
+
+    Polynomial& operator/=(const Polynomial& g) {
+        return *this = div_mod(g).first;
+    }
+    Polynomial& operator%=(const Polynomial& g) {
+        return *this = div_mod(g).second;
+    }
+
+    T operator()(const T& x) const {
+        T result(0);
+        for (size_t i = coeffs.size(); i-- > 0;) {
+            result *= x;
+            result += coeffs[i];
+        }
+        return result;
+    }
+
+    std::vector<T> evaluate(const std::vector<T>& points) const {
+        std::vector<T> values;
+        values.reserve(points.size());
+        if (points.size() < MULTIPOINT_THRESHOLD) {
+            for (const auto& point : points) {
+                values.push_back((*this)(point));
+            }
+            return values;
+        }
+
+        std::vector<std::vector<Polynomial>> tree(1);
+        for (const auto& point : points) {
+            tree[0].push_back(Polynomial{-point, T(1)});
+        }
+        while (tree.back().size() > 1) {
+            const std::vector<Polynomial>& level = tree.back();
+            std::vector<Polynomial> next;
+            for (size_t i = 0; i + 1 < level.size(); i += 2) {
+                next.push_back(level[i] * level[i + 1]);
+            }
+            if (level.size() % 2) {
+                next.push_back(level.back());
+            }
+            tree.push_back(std::move(next));
+        }
+
+        std::vector<Polynomial> remainders{*this % tree.back()[0]};
+        for (size_t level = tree.size() - 1; level-- > 0;) {
+            std::vector<Polynomial> next;
+            for (size_t i = 0; i < tree[level].size(); ++i) {
+                next.push_back(remainders[i / 2] % tree[level][i]);
+            }
+            remainders = std::move(next);
+        }
+        for (const auto& remainder : remainders) {
+            values.push_back(remainder[0]);
+        }
+        return values;
+    }
+
+    std::string toString() const {
+        if (coeffs.empty()) {
+            return "0";
+        }
+        std::string s;
+        for (size_t i = coeffs.size(); i-- > 0;) {
+            if (coeffs[i] == T(0)) {
+                continue;
+            }
+            std::string c = coeffs[i].toString();
+            bool negative = c[0] == '-';
+            if (negative) {
+                c.erase(0, 1);
+            }
+            if (s.empty()) {
+                s += negative ? "-" : "";
+            } else {
+                s += negative ? " - " : " + ";
+            }
+            if (i == 0) {
+                s += c;
+                continue;
+            }
+            if (c != "1") {
+                s += c + "*";
+            }
+            s += i > 1 ? "x^" + std::to_string(i) : "x";
+        }
+        return s;
+    }
+};
+
+template <typename T>
+Polynomial<T> operator+(Polynomial<T> a, const Polynomial<T>& b) {
+    a += b;
+    return a;
+}
+template <typename T>
+Polynomial<T> operator-(Polynomial<T> a, const Polynomial<T>& b) {
+    a -= b;
+    return a;
+}
+template <typename T>
+Polynomial<T> operator*(Polynomial<T> a, const Polynomial<T>& b) {
+    a *= b;
+    return a;
+}
+template <typename T>
+Polynomial<T> operator/(Polynomial<T> a, const Polynomial<T>& b) {
+    a /= b;
+    return a;
+}
+template <typename T>
+Polynomial<T> operator%(Polynomial<T> a, const Polynomial<T>& b) {
+    a %= b;
+    return a;
+}
+
+template <typename T>
+std::ostream& operator<<(std::ostream& out, const Polynomial<T>& p) {
+    return out << p.toString();
+}
+
+BigInteger content(const Polynomial<BigInteger>& p) {
+    BigInteger result = 0;
+    for (const auto& c : p.coefficients()) {
+        result = gcd(result, c);
+    }
+    return result;
+}
+
+Polynomial<BigInteger> primitive_part(const Polynomial<BigInteger>& p) {
+    if (!p) {
+        return p;
+    }
+    BigInteger divisor = content(p);
+    if (p.leading() < 0) {
+        divisor.changeSign();
+    }
+    std::vector<BigInteger> values = p.coefficients();
+    for (auto& value : values) {
+        value = divexact(value, divisor);
+    }
+    return Polynomial<BigInteger>(std::move(values));
+}
+
+Polynomial<BigInteger> pseudo_remainder(const Polynomial<BigInteger>& a, const Polynomial<BigInteger>& b) {
+    std::vector<BigInteger> rest = a.coefficients();
+    const std::vector<BigInteger>& divisor = b.coefficients();
+    size_t db = divisor.size() - 1;
+    for (size_t i = rest.size(); i-- > db;) {
+        BigInteger lead = rest[i];
+        for (size_t j = 0; j < i; ++j) {
+            rest[j] *= divisor.back();
+        }
+        for (size_t j = 0; j < db; ++j) {
+            submul(rest[i - db + j], lead, divisor[j]);
+        }
+        rest[i] = 0;
+    }
+    rest.resize(db);
+    return Polynomial<BigInteger>(std::move(rest));
+}
+
+Polynomial<BigInteger> gcd(Polynomial<BigInteger> a, Polynomial<BigInteger> b) {
+    if (!a) {
+        return primitive_part(b) * Polynomial<BigInteger>(content(b));
+    }
+    if (!b) {
+        return primitive_part(a) * Polynomial<BigInteger>(content(a));
+    }
+    BigInteger scale = gcd(content(a), content(b));
+    a = primitive_part(a);
+    b = primitive_part(b);
+    if (a.degree() < b.degree()) {
+        std::swap(a, b);
+    }
+    BigInteger g = 1;
+    BigInteger h = 1;
+    while (b) {
+        size_t delta = a.coefficients().size() - b.coefficients().size();
+        Polynomial<BigInteger> rest = pseudo_remainder(a, b);
+        a = std::move(b);
+        BigInteger divisor = g;
+        for (size_t i = 0; i < delta; ++i) {
+            divisor *= h;
+        }
+        std::vector<BigInteger> values = rest.coefficients();
+        for (auto& value : values) {
+            value = divexact(value, divisor);
+        }
+        b = Polynomial<BigInteger>(std::move(values));
+        g = a.leading();
+        if (delta == 1) {
+            h = g;
+        } else if (delta > 1) {
+            BigInteger power = g;
+            BigInteger base = h;
+            for (size_t i = 1; i < delta; ++i) {
+                power *= g;
+            }
+            for (size_t i = 2; i < delta; ++i) {
+                base *= h;
+            }
+            h = divexact(power, base);
+        }
+    }
+    return primitive_part(a) * Polynomial<BigInteger>(scale);
+}
+
+Polynomial<Rational> gcd(Polynomial<Rational> a, Polynomial<Rational> b) {
+    while (b) {
+        a %= b;
+        std::swap(a, b);
+    }
+    if (a) {
+        a *= Polynomial<Rational>(Rational(1) / a.leading());
+    }
+    return a;
+}
+
+class ModularBasis {
+private:
+    std::vector<uint64_t> primes;
+    std::vector<uint64_t> cofactor_inverses;
+    std::vector<std::vector<BigInteger>> tree;
+
+public:
+    explicit ModularBasis(size_t bits, unsigned threads = 1) : primes(wordPrimes(bits / 30 + 1)) {
+        tree.emplace_back();
+        for (uint64_t p : primes) {
+            tree[0].emplace_back(static_cast<long long>(p));
+        }
+        while (tree.back().size() > 1) {
+            const std::vector<BigInteger>& level = tree.back();
+            std::vector<BigInteger> next((level.size() + 1) / 2);
+            parallelFor(next.size(), threads, [&level, &next](size_t first, size_t last) {
+                for (size_t i = first; i < last; ++i) {
+                    next[i] = 2 * i + 1 < level.size() ? level[2 * i] * level[2 * i + 1] : level[2 * i];
+                }
+            });
+            tree.push_back(std::move(next));
+        }
+
+        cofactor_inverses.resize(primes.size());
+        parallelFor(primes.size(), threads, [this](size_t first, size_t last) {
+            for (size_t i = first; i < last; ++i) {
+                uint64_t p = primes[i];
+                uint64_t cofactor = 1;
+                for (size_t j = 0; j < primes.size(); ++j) {
+                    if (j != i) {
+                        cofactor = cofactor * (primes[j] % p) % p;
+                    }
                 }
+                cofactor_inverses[i] = powMod(cofactor, p - 2, p);
             }
-            if (carry) {
-                size_t i = x.digits.size();
-                while (digits[i] == 0) {
-                    digits[i] = REAL_BASE - 1;
-                    ++i;
+        });
+    }
+
+    size_t size() const {
+        return primes.size();
+    }
+    uint64_t prime(size_t i) const {
+        return primes[i];
+    }
+    const BigInteger& modulus() const {
+        return tree.back()[0];
+    }
+
+    // Residues in [0, p) for every prime. Each one is a Horner evaluation of x's base-10^9 words modulo that prime,
+    // so the cost is the word count times the prime count; there is no remainder tree. The GMP backend takes
+    // mpz_fdiv_ui per prime instead.
+    std::vector<uint64_t> reduce(const BigInteger& x, unsigned threads = 1) const {
+#ifdef BIGINTEGER_USE_GMP
+        std::vector<uint64_t> residues(primes.size());
+        parallelFor(primes.size(), threads, [this, &x, &residues](size_t first, size_t last) {
+            for (size_t i = first; i < last; ++i) {
+                residues[i] = mpz_fdiv_ui(x.raw(), primes[i]);
+            }
+        });
+        return residues;
+#else
+        std::vector<uint64_t> words = x.wordsReversed();
+        std::vector<uint64_t> residues(primes.size());
+        parallelFor(primes.size(), threads, [this, &x, &words, &residues](size_t first, size_t last) {
+            for (size_t i = first; i < last; ++i) {
+                uint64_t p = primes[i];
+                uint64_t residue = 0;
+                for (uint64_t word : words) {
+                    residue = (residue * BigInteger::WORD_BASE + word) % p;
                 }
-                --digits[i];
+                residues[i] = x < 0 && residue ? p - residue : residue;
             }
-            deleteZeroes();
+        });
+        return residues;
+#endif
+    }
+
+    // The value congruent to the residues in the symmetric range [-(M - 1) / 2, (M - 1) / 2], M = modulus().
+    BigInteger reconstruct(const std::vector<uint64_t>& residues, unsigned threads = 1) const {
+        if (residues.size() != primes.size()) {
+            throw std::invalid_argument("ModularBasis: residue count mismatch");
         }
-        return *this;
+        std::vector<BigInteger> sums(primes.size());
+        long double quotient = 0;
+        for (size_t i = 0; i < primes.size(); ++i) {
+            uint64_t t = residues[i] % primes[i] * cofactor_inverses[i] % primes[i];
+            sums[i] = static_cast<long long>(t);
+            quotient += static_cast<long double>(t) / static_cast<long double>(primes[i]);
+        }
+        for (size_t level = 0; level + 1 < tree.size(); ++level) {
+            std::vector<BigInteger> next(tree[level + 1].size());
+            parallelFor(next.size(), threads, [this, level, &sums, &next](size_t first, size_t last) {
+                for (size_t i = first; i < last; ++i) {
+                    if (2 * i + 1 < sums.size()) {
+                        next[i] = sums[2 * i] * tree[level][2 * i + 1];
+                        addmul(next[i], sums[2 * i + 1], tree[level][2 * i]);
+                    } else {
+                        next[i] = std::move(sums[2 * i]);
+                    }
+                }
+            });
+            sums = std::move(next);
+        }
+
+        BigInteger value = std::move(sums[0]);
+        submul_ui(value, modulus(), static_cast<unsigned long long>(quotient));
+        while (value < 0) {
+            value += modulus();
+        }
+        while (value >= modulus()) {
+            value -= modulus();
+        }
+        BigInteger twice = value;
+        twice.multiply(2);
+        if (twice > modulus()) {
+            value -= modulus();
+        }
+        return value;
     }
+};
 
-    BigInteger& operator++() {
-        return *this += 1;
+class MultiModular {
+private:
+    std::shared_ptr<const ModularBasis> basis;
+    std::vector<uint64_t> residues;
+
+    void checkBasis(const MultiModular& x) const {
+        if (basis != x.basis) {
+            throw std::invalid_argument("MultiModular: operands use different bases");
+        }
     }
-    BigInteger operator++(int) {
-        BigInteger tmp = *this;
-        ++*this;
-        return tmp;
+
+public:
+    MultiModular(std::shared_ptr<const ModularBasis> basis, const BigInteger& x, unsigned threads = 1)
+        : basis(std::move(basis)) {
+        residues = this->basis->reduce(x, threads);
+    }
+    MultiModular(std::shared_ptr<const ModularBasis> basis, long long x = 0)
+        : basis(std::move(basis)), residues(this->basis->size()) {
+        for (size_t i = 0; i < residues.size(); ++i) {
+            auto p = static_cast<long long>(this->basis->prime(i));
+            long long residue = x % p;
+            residues[i] = static_cast<uint64_t>(residue < 0 ? residue + p : residue);
+        }
     }
 
-    BigInteger& operator-=(const BigInteger& x) {
-        changeSign();
-        *this += x;
-        changeSign();
+    const ModularBasis& modular_basis() const {
+        return *basis;
+    }
+    const std::vector<uint64_t>& residue_vector() const {
+        return residues;
+    }
+
+    BigInteger toBigInteger(unsigned threads = 1) const {
+        return basis->reconstruct(residues, threads);
+    }
+    explicit operator BigInteger() const {
+        return toBigInteger();
+    }
+
+    MultiModular operator+() const {
         return *this;
     }
-    BigInteger& operator--() {
-        return *this += -1;
+    MultiModular operator-() const {
+        MultiModular copy = *this;
+        for (size_t i = 0; i < residues.size(); ++i) {
+            uint64_t p = basis->prime(i);
+            copy.residues[i] = residues[i] ? p - residues[i] : 0;
+        }
+        return copy;
+    }
+
+    MultiModular& operator+=(const MultiModular& x) {
+        checkBasis(x);
+        for (size_t i = 0; i < residues.size(); ++i) {
+            uint64_t p = basis->prime(i);
+            uint64_t sum = residues[i] + x.residues[i];
+            residues[i] = sum >= p ? sum - p : sum;
+        }
+        return *this;
+    }
+    MultiModular& operator-=(const MultiModular& x) {
+        checkBasis(x);
+        for (size_t i = 0; i < residues.size(); ++i) {
+            uint64_t p = basis->prime(i);
+            uint64_t difference = residues[i] + p - x.residues[i];
+            residues[i] = difference >= p ? difference - p : difference;
+        }
+        return *this;
+    }
+    MultiModular& operator*=(const MultiModular& x) {
+        checkBasis(x);
+        for (size_t i = 0; i < residues.size(); ++i) {
+            residues[i] = residues[i] * x.residues[i] % basis->prime(i);
+        }
+        return *this;
+    }
+
+    bool operator==(const MultiModular& x) const {
+        return basis == x.basis && residues == x.residues;
+    }
+};
+
+MultiModular operator+(MultiModular a, const MultiModular& b) {
+    a += b;
+    return a;
+}
+MultiModular operator-(MultiModular a, const MultiModular& b) {
+    a -= b;
+    return a;
+}
+MultiModular operator*(MultiModular a, const MultiModular& b) {
+    a *= b;
+    return a;
+}
+
+enum class RoundingMode { NearestEven, TowardZero, Down, Up };
+
+class BigFloat {
+private:
+    static const size_t DEFAULT_PRECISION = 50;
+    static const size_t GUARD_DIGITS = 3;
+    static const size_t SQRT_SCHOOLBOOK_LIMBS = 16;
+
+    BigInteger mantissa;
+    int64_t exponent = 0;
+    size_t digits_precision;
+    RoundingMode mode;
+
+    struct Remainder {
+        int half;
+        bool nonzero;
+    };
+
+#ifdef BIGINTEGER_USE_GMP
+    // mpz_sizeinbase may count one digit too many.
+    static size_t decimalDigits(const BigInteger& m) {
+        size_t count = mpz_sizeinbase(m.raw(), BigInteger::USER_BASE);
+        return count > 1 && mpz_cmpabs(m.raw(), BigInteger::power10(count - 1).get_mpz_t()) < 0 ? count - 1 : count;
+    }
+
+    // Drops the lowest count decimal digits of m (toward zero) and reports how they compare with half a unit.
+    static Remainder truncate(BigInteger& m, size_t count) {
+        mpz_class unit = BigInteger::power10(count);
+        mpz_class rest;
+        mpz_tdiv_qr(m.raw(), rest.get_mpz_t(), m.raw(), unit.get_mpz_t());
+        mpz_abs(rest.get_mpz_t(), rest.get_mpz_t());
+        int half = mpz_cmp(mpz_class(2 * rest).get_mpz_t(), unit.get_mpz_t());
+        return {half > 0 ? 1 : half == 0 ? 0 : -1, rest != 0};
     }
-    BigInteger operator--(int) {
-        BigInteger tmp = *this;
-        --*this;
-        return tmp;
+#else
+    static size_t decimalDigits(const BigInteger& m) {
+        long long top = m.digits.back();
+        return (m.digits.size() - 1) * BigInteger::DIGIT_SIZE + (top >= 100 ? 3 : top >= 10 ? 2 : 1);
     }
 
-    BigInteger& operator*=(const BigInteger& x) {
-        size_t n = to_pow2(digits.size() + x.digits.size());
-        std::vector<std::complex<long double>> fa(n);
-        std::vector<std::complex<long double>> fb(n);
-        for (size_t i = 0; i < digits.size(); ++i) {
-            fa[i] = digits[i];
+    static long long decimalDigit(const BigInteger& m, size_t i) {
+        size_t limb = i / BigInteger::DIGIT_SIZE;
+        if (limb >= m.digits.size()) {
+            return 0;
         }
-        for (size_t i = 0; i < x.digits.size(); ++i) {
-            fb[i] = x.digits[i];
+        long long value = m.digits[limb];
+        for (size_t k = i % BigInteger::DIGIT_SIZE; k > 0; --k) {
+            value /= BigInteger::USER_BASE;
         }
+        return value % BigInteger::USER_BASE;
+    }
 
-        fft(fa, false);
-        fft (fb, false);
-        for (size_t i = 0; i < n; ++i) {
-            fa[i] *= fb[i];
+    // Drops the lowest count decimal digits of m (toward zero) and reports how they compare with half a unit.
+    static Remainder truncate(BigInteger& m, size_t count) {
+        if (count == 0) {
+            return {-1, false};
         }
-        fft (fa, true);
-
-        digits.resize(n);
-        for (size_t i = 0; i < n; ++i) {
-            digits[i] = static_cast<long long>(roundl(fa[i].real()));
+        size_t top = count - 1;
+        bool below_zero = true;
+        for (size_t i = 0; i < top / BigInteger::DIGIT_SIZE && i < m.digits.size(); ++i) {
+            below_zero = below_zero && m.digits[i] == 0;
         }
-
-        toCarry();
-        is_negative ^= x.is_negative;
-        deleteZeroes();
-        return *this;
-    }
-
-    void multiply_pow10(size_t q) {
-        if (*this) {
-            digits.insert(digits.begin(), q / DIGIT_SIZE, 0);
-            if (q %= DIGIT_SIZE) {
-                long long x = USER_BASE;
-                while (--q) {
-                    x *= USER_BASE;
-                }
-                multiply(x);
-            }
+        for (size_t i = top - top % BigInteger::DIGIT_SIZE; i < top; ++i) {
+            below_zero = below_zero && decimalDigit(m, i) == 0;
         }
-    }
+        long long lead = decimalDigit(m, top);
+        Remainder rest{lead > 5 || (lead == 5 && !below_zero) ? 1 : lead == 5 ? 0 : -1, lead != 0 || !below_zero};
 
-    std::pair<BigInteger, BigInteger> div_mod(const BigInteger& x) const {
-        BigInteger div;
-        BigInteger mod;
-        for (size_t i = digits.size() - 1; i < digits.size(); --i) {
-            if (mod.digits.back()) {
-                mod.digits.insert(mod.digits.begin(), 1, digits[i]);
-            } else {
-                mod.digits[0] = digits[i];
-            }
-            div.digits.push_back(0);
-
-            if (mod >= x) {
-                long long &left = div.digits.back();
-                long long right = REAL_BASE;
-                while (left + 1 < right) {
-                    long long md = (left + right) / 2;
-                    if (::multiply(x, md) <= mod) {
-                        left = md;
-                    } else {
-                        right = md;
-                    }
-                }
-                mod -= ::multiply(x, left);
+        m.dropLimbs(count / BigInteger::DIGIT_SIZE);
+        if (size_t shift = count % BigInteger::DIGIT_SIZE) {
+            long long divisor = shift == 1 ? 10 : 100;
+            long long carry = 0;
+            for (size_t i = m.digits.size(); i-- > 0;) {
+                long long current = carry * BigInteger::REAL_BASE + m.digits[i];
+                m.digits[i] = current / divisor;
+                carry = current % divisor;
             }
+            m.deleteZeroes();
         }
-        reverse(div.digits.begin(), div.digits.end());
-        div.is_negative = is_negative ^ x.is_negative;
-        mod.is_negative = mod && is_negative;
-        div.deleteZeroes();
-        return {div, mod};
+        return rest;
     }
+#endif
 
-    BigInteger& operator/=(const BigInteger& x) {
-        return *this = div_mod(x).first;
+    // Replaces the digits of m below 10^floor by a single sticky digit at 10^(floor - 1).
+    static void compress(BigInteger& m, int64_t& e, int64_t floor) {
+        bool negative = m < 0;
+        Remainder rest = truncate(m, static_cast<size_t>(floor - e));
+        m.applyAbs();
+        m.multiply(BigInteger::USER_BASE);
+        if (rest.nonzero) {
+            m += 1;
+        }
+        if (negative) {
+            m.changeSign();
+        }
+        e = floor - 1;
     }
 
-    BigInteger& operator%=(const BigInteger& x) {
-        return *this = div_mod(x).second;
+    int64_t top() const {
+        return exponent + static_cast<int64_t>(decimalDigits(mantissa));
     }
 
-
-    bool operator==(const BigInteger&) const = default;
-    friend std::strong_ordering operator<=>(const BigInteger& x, const BigInteger& y) {
-        std::strong_ordering less = std::strong_ordering::less;
-        std::strong_ordering equal = std::strong_ordering::equal;
-        std::strong_ordering greater = std::strong_ordering::greater;
-
-        if (x.is_negative && !y.is_negative) {
-            return less;
-        }
-        if (!x.is_negative && y.is_negative) {
-            return greater;
+    void normalize() {
+        if (!mantissa) {
+            exponent = 0;
+            return;
         }
-        if (x.is_negative) {
-            std::swap(less, greater);
+        size_t current = decimalDigits(mantissa);
+        if (current <= digits_precision) {
+            return;
         }
-        if (x.digits.size() < y.digits.size()) {
-            return less;
+        bool negative = mantissa < 0;
+        size_t drop = current - digits_precision;
+        Remainder rest = truncate(mantissa, drop);
+        exponent += static_cast<int64_t>(drop);
+        bool away = false;
+        switch (mode) {
+            case RoundingMode::NearestEven:
+                away = rest.half > 0 || (rest.half == 0 && mantissa.mod_small(2) == 1);
+                break;
+            case RoundingMode::TowardZero:
+                break;
+            case RoundingMode::Down:
+                away = rest.nonzero && negative;
+                break;
+            case RoundingMode::Up:
+                away = rest.nonzero && !negative;
+                break;
         }
-        if (x.digits.size() > y.digits.size()) {
-            return greater;
+        if (away) {
+            mantissa += negative ? -1 : 1;
+            if (decimalDigits(mantissa) > digits_precision) {
+                truncate(mantissa, 1);
+                ++exponent;
+            }
         }
+    }
 
-        size_t i = x.digits.size() - 1;
-        while (i < x.digits.size() && x.digits[i] == y.digits[i]) {
-            --i;
+    // Sets *this to num / den * 10^e rounded, with den > 0. The quotient goes through Divisor, so long denominators
+    // divide by Barrett reduction instead of the schoolbook loop.
+    void assignQuotient(BigInteger num, const BigInteger& den, int64_t e) {
+        bool negative = num < 0;
+        num.applyAbs();
+        size_t wanted = digits_precision + 2 + decimalDigits(den);
+        size_t shift = wanted > decimalDigits(num) ? wanted - decimalDigits(num) : 0;
+        num.multiply_pow10(shift);
+        auto [div, mod] = Divisor(den).div_mod(num);
+        e -= static_cast<int64_t>(shift);
+        if (mod) {
+            div.multiply(BigInteger::USER_BASE);
+            div += 1;
+            --e;
         }
-        if (i > x.digits.size()) {
-            return equal;
+        mantissa = std::move(div);
+        if (negative) {
+            mantissa.changeSign();
         }
-
-        return x.digits[i] < y.digits[i] ? less : greater;
+        exponent = e;
+        normalize();
     }
 
-    std::string toString() const {
-        std::string s(DIGIT_SIZE * digits.size(), '\0');
-        for (size_t i = 0; i < digits.size(); ++i) {
-            long long t = digits[i];
-            for (size_t j = DIGIT_SIZE * i; j < DIGIT_SIZE * (i + 1); ++j) {
-                s[j] = std::to_string(t % USER_BASE)[0];
-                t /= USER_BASE;
+    // floor(sqrt(n)) for n > 0. Past a few limbs the root of n without its low 2h limbs, h a fifth of the length,
+    // is shifted back into place and refined by one Newton step dividing through Divisor. The starting error below
+    // 2 * B^h then shrinks under one unit, and the step never lands below the root.
+    static BigInteger isqrt(const BigInteger& n) {
+#ifdef BIGINTEGER_USE_GMP
+        BigInteger root;
+        mpz_sqrt(root.raw(), n.raw());
+        return root;
+#else
+        size_t limbs = n.digits.size();
+        if (limbs <= SQRT_SCHOOLBOOK_LIMBS) {
+            BigInteger x = 1;
+            x.multiply_pow10((decimalDigits(n) + 1) / 2);
+            while (true) {
+                BigInteger y = n / x;
+                y += x;
+                y.divideSmall(2);
+                if (y >= x) {
+                    return x;
+                }
+                x = std::move(y);
             }
         }
-        while (s.size() > 1 && s.back() == '0') {
-            s.pop_back();
+        size_t h = limbs / 5;
+        BigInteger top = n;
+        top.dropLimbs(2 * h);
+        BigInteger x = isqrt(top);
+        x.multiply_pow10(BigInteger::DIGIT_SIZE * h);
+        BigInteger y = Divisor(x).div(n);
+        y += x;
+        y.divideSmall(2);
+        while (y * y > n) {
+            y -= 1;
         }
-        if (is_negative) {
-            s.push_back('-');
+        return y;
+#endif
+    }
+
+public:
+    BigFloat(const BigInteger& value = 0, size_t precision = DEFAULT_PRECISION,
+             RoundingMode rounding = RoundingMode::NearestEven)
+        : mantissa(value), digits_precision(precision), mode(rounding) {
+        if (precision == 0) {
+            throw std::invalid_argument("BigFloat: precision must be positive");
         }
-        reverse(s.begin(), s.end());
-        return s;
+        normalize();
+    }
+    BigFloat(long long value, size_t precision = DEFAULT_PRECISION,
+             RoundingMode rounding = RoundingMode::NearestEven)
+        : BigFloat(BigInteger(value), precision, rounding) {}
+    explicit BigFloat(const Rational& value, size_t precision = DEFAULT_PRECISION,
+             RoundingMode rounding = RoundingMode::NearestEven)
+        : BigFloat(BigInteger(0), precision, rounding) {
+        assignQuotient(value.numerator(), value.denominator(), 0);
     }
 
-    friend std::istream& operator>>(std::istream& in, BigInteger& x) {
-        std::string s;
-        in >> s;
-        reverse(s.begin(), s.end());
-        if (s.back() == '-') {
-            x.is_negative = true;
-            s.pop_back();
-        } else {
-            x.is_negative = false;
+    explicit BigFloat(std::string_view text, size_t precision = DEFAULT_PRECISION,
+                      RoundingMode rounding = RoundingMode::NearestEven)
+        : BigFloat(BigInteger(0), precision, rounding) {
+        bool negative = !text.empty() && text[0] == '-';
+        if (!text.empty() && (text[0] == '-' || text[0] == '+')) {
+            text.remove_prefix(1);
+        }
+        std::string digits;
+        int64_t e = 0;
+        size_t i = 0;
+        bool point = false;
+        for (; i < text.size() && ((text[i] >= '0' && text[i] <= '9') || (text[i] == '.' && !point)); ++i) {
+            if (text[i] == '.') {
+                point = true;
+            } else {
+                digits += text[i];
+                e -= point ? 1 : 0;
+            }
         }
-        while (s.size() % DIGIT_SIZE) {
-            s.push_back('0');
+        if (digits.empty()) {
+            throw std::invalid_argument("BigFloat: no digits");
         }
-        x.digits.resize(s.size() / DIGIT_SIZE);
-
-        for (size_t i = 0; i < x.digits.size(); ++i) {
-            x.digits[i] = 0;
-            for (size_t j = DIGIT_SIZE * (i + 1); j > DIGIT_SIZE * i; --j) {
-                x.digits[i] = USER_BASE * x.digits[i] + (s[j - 1] - '0');
+        if (i < text.size() && (text[i] == 'e' || text[i] == 'E')) {
+            long long shift = 0;
+            const char* last = text.data() + text.size();
+            auto [ptr, ec] = std::from_chars(text.data() + i + 1 + (i + 1 < text.size() && text[i + 1] == '+'), last, shift);
+            if (ec != std::errc() || ptr != last) {
+                throw std::invalid_argument("BigFloat: malformed exponent");
             }
+            e += shift;
+        } else if (i != text.size()) {
+            throw std::invalid_argument("BigFloat: unexpected character");
         }
-        x.deleteZeroes();
-        return in;
+        mantissa = BigInteger(digits);
+        if (negative) {
+            mantissa.changeSign();
+        }
+        exponent = e;
+        normalize();
     }
 
-};
-
-BigInteger multiply(BigInteger ans, long long x) {
-    ans.multiply(x);
-    return ans;
-}
-
-std::ostream& operator<<(std::ostream& out, const BigInteger& x) {
-    return out << x.toString();
-}
-BigInteger operator"" _bi(unsigned long long n) {
-    return BigInteger(static_cast<long long>(n));
-}
-
-BigInteger operator+(BigInteger x, const BigInteger& y) {
-    x += y;
-    return x;
-}
-BigInteger operator-(BigInteger x, const BigInteger& y) {
-    x -= y;
-    return x;
-}
-BigInteger operator*(BigInteger x, const BigInteger& y) {
-    x *= y;
-    return x;
-}
-BigInteger operator/(BigInteger x, const BigInteger& y) {
-    x /= y;
-    return x;
-}
-BigInteger operator%(BigInteger x, const BigInteger& y) {
-    x %= y;
-    return x;
-}
-
-
-BigInteger gcd(BigInteger a, BigInteger b) {
-    a.applyAbs();
-    b.applyAbs();
-
-    while (b) {
-        a %= b;
-        a.swap(b);
+    size_t precision() const {
+        return digits_precision;
     }
-    return a;
-}
-
-class Rational {
-private:
-    static const size_t MANTISSA_SIZE = 20;
-    BigInteger x;
-    BigInteger y;
-
-    void reduce() {
-        if (y < 0) {
-            x.changeSign();
-            y.changeSign();
-        }
-        BigInteger g = gcd(x, y);
-        x /= g;
-        y /= g;
+    RoundingMode rounding_mode() const {
+        return mode;
     }
-public:
-    Rational(const BigInteger& x): x(x), y(1) {}
-    Rational(const BigInteger& x, const BigInteger& y): x(x), y(y) {
-        reduce();
+    const BigInteger& significand() const {
+        return mantissa;
+    }
+    int64_t exponent10() const {
+        return exponent;
     }
 
-    Rational(long long x) : x(x), y(1) {}
-    Rational(long long x, long long y) : x(x), y(y) {
-        reduce();
+    void set_precision(size_t precision) {
+        if (precision == 0) {
+            throw std::invalid_argument("BigFloat: precision must be positive");
+        }
+        digits_precision = precision;
+        normalize();
+    }
+    void set_rounding_mode(RoundingMode rounding) {
+        mode = rounding;
     }
-    Rational() : x(0), y(1) {}
 
-    explicit operator double() const {
-        return atof(asDecimal(MANTISSA_SIZE).c_str());
+    explicit operator bool() const {
+        return static_cast<bool>(mantissa);
     }
 
-    Rational operator+() const {
+    BigFloat operator+() const {
         return *this;
     }
-    Rational operator-() const {
-        Rational copy(*this);
-        copy.x.changeSign();
+    BigFloat operator-() const {
+        BigFloat copy = *this;
+        copy.mantissa.changeSign();
         return copy;
     }
 
-    Rational& operator+=(const Rational& t) {
-        x *= t.y;
-        x += t.x * y;
-        y *= t.y;
-        reduce();
+    BigFloat& operator+=(const BigFloat& x) {
+        if (!x.mantissa) {
+            return *this;
+        }
+        BigInteger other = x.mantissa;
+        int64_t other_exponent = x.exponent;
+        if (mantissa) {
+            auto guard = static_cast<int64_t>(digits_precision + GUARD_DIGITS);
+            if (x.top() + guard < top()) {
+                compress(other, other_exponent, std::min(top() - guard, exponent));
+            } else if (top() + guard < x.top()) {
+                compress(mantissa, exponent, std::min(x.top() - guard, other_exponent));
+            }
+            int64_t e = std::min(exponent, other_exponent);
+            mantissa.multiply_pow10(static_cast<size_t>(exponent - e));
+            other.multiply_pow10(static_cast<size_t>(other_exponent - e));
+            exponent = e;
+        } else {
+            exponent = other_exponent;
+        }
+        mantissa += other;
+        normalize();
         return *this;
     }
-    Rational& operator-=(const Rational& t) {
-        x.changeSign();
-        *this += t;
-        x.changeSign();
-        return *this;
+    BigFloat& operator-=(const BigFloat& x) {
+        return *this += -x;
     }
-
-    Rational& operator*=(const Rational& t) {
-        x *= t.x;
-        y *= t.y;
-        reduce();
+    BigFloat& operator*=(const BigFloat& x) {
+        mantissa *= x.mantissa;
+        exponent += x.exponent;
+        normalize();
         return *this;
     }
-    Rational& operator/=(const Rational& t) {
-        x *= t.y;
-        y *= t.x;
-        reduce();
+    BigFloat& operator/=(const BigFloat& x) {
+        if (!x.mantissa) {
+            throw std::domain_error("BigFloat: division by zero");
+        }
+        BigInteger den = x.mantissa;
+        BigInteger num = std::move(mantissa);
+        if (den < 0) {
+            den.changeSign();
+            num.changeSign();
+        }
+        assignQuotient(std::move(num), den, exponent - x.exponent);
         return *this;
     }
 
-    bool operator==(const Rational&) const = default;
-    friend std::strong_ordering operator<=>(const Rational& digits, const Rational& b) {
-        return digits.x * b.y <=> b.x * digits.y;
+    friend BigFloat sqrt(BigFloat x) {
+        if (x.mantissa < 0) {
+            throw std::domain_error("BigFloat: square root of a negative number");
+        }
+        if (!x.mantissa) {
+            return x;
+        }
+        size_t wanted = 2 * (x.digits_precision + 2);
+        size_t current = decimalDigits(x.mantissa);
+        size_t shift = wanted > current ? wanted - current : 0;
+        if ((x.exponent - static_cast<int64_t>(shift)) % 2 != 0) {
+            ++shift;
+        }
+        x.mantissa.multiply_pow10(shift);
+        BigInteger root = isqrt(x.mantissa);
+        x.exponent = (x.exponent - static_cast<int64_t>(shift)) / 2;
+        bool exact = root * root == x.mantissa;
+        if (!exact) {
+            root.multiply(10);
+            root += 1;
+            --x.exponent;
+        }
+        x.mantissa = std::move(root);
+        x.normalize();
+        return x;
     }
 
-    std::string toString() const {
-        return x.toString() + (y != 1_bi ? '/' + y.toString() : "");
+    friend std::strong_ordering operator<=>(const BigFloat& a, const BigFloat& b) {
+        int sign_a = a.mantissa < 0 ? -1 : a.mantissa ? 1 : 0;
+        int sign_b = b.mantissa < 0 ? -1 : b.mantissa ? 1 : 0;
+        if (sign_a != sign_b || sign_a == 0) {
+            return sign_a <=> sign_b;
+        }
+        if (a.top() != b.top()) {
+            return sign_a > 0 ? a.top() <=> b.top() : b.top() <=> a.top();
+        }
+        BigInteger left = a.mantissa;
+        BigInteger right = b.mantissa;
+        int64_t e = std::min(a.exponent, b.exponent);
+        left.multiply_pow10(static_cast<size_t>(a.exponent - e));
+        right.multiply_pow10(static_cast<size_t>(b.exponent - e));
+        return left <=> right;
+    }
+    friend bool operator==(const BigFloat& a, const BigFloat& b) {
+        return (a <=> b) == 0;
     }
 
-    std::string asDecimal(size_t precision=0) const {
-        auto [div, mod] = x.div_mod(y);
-        std::string integer = div.toString();
-        if (precision == 0) {
-            return integer;
+    Rational toRational() const {
+        BigInteger scale = 1;
+        scale.multiply_pow10(static_cast<size_t>(exponent < 0 ? -exponent : exponent));
+        if (exponent >= 0) {
+            return Rational(mantissa * scale);
         }
-        mod.applyAbs();
-        mod.multiply_pow10(precision);
-        mod /= y;
-        std::string s = mod.toString();
-        if (integer == "0" && x < 0 && mod) {
-            integer = "-0";
+        return Rational(mantissa, scale);
+    }
+    explicit operator Rational() const {
+        return toRational();
+    }
+
+    std::string toString() const {
+        if (!mantissa) {
+            return "0";
         }
-        return integer + '.' + std::string(precision - s.size(), '0') + s;
+        std::string digits = mantissa.toString();
+        std::string sign;
+        if (digits[0] == '-') {
+            sign = "-";
+            digits.erase(0, 1);
+        }
+        int64_t point = exponent + static_cast<int64_t>(digits.size());
+        if (exponent <= 0 && point > -6) {
+            if (point <= 0) {
+                digits.insert(0, "0." + std::string(static_cast<size_t>(-point), '0'));
+            } else {
+                digits.insert(static_cast<size_t>(point), ".");
+            }
+            while (digits.back() == '0') {
+                digits.pop_back();
+            }
+            if (digits.back() == '.') {
+                digits.pop_back();
+            }
+            return sign + digits;
+        }
+        if (exponent > 0 && point <= static_cast<int64_t>(digits_precision)) {
+            return sign + digits + std::string(static_cast<size_t>(exponent), '0');
+        }
+        while (digits.size() > 1 && digits.back() == '0') {
+            digits.pop_back();
+        }
+        if (digits.size() > 1) {
+            digits.insert(1, ".");
+        }
+        return sign + digits + "e" + std::to_string(point - 1);
     }
 };
 
-Rational operator+(Rational a, const Rational& b) {
+BigFloat operator+(BigFloat a, const BigFloat& b) {
     a += b;
     return a;
 }
-Rational operator-(Rational a, const Rational& b) {
+BigFloat operator-(BigFloat a, const BigFloat& b) {
     a -= b;
     return a;
 }
-Rational operator*(Rational a, const Rational& b) {
+BigFloat operator*(BigFloat a, const BigFloat& b) {
     a *= b;
     return a;
 }
-Rational operator/(Rational a, const Rational& b) {
+BigFloat operator/(BigFloat a, const BigFloat& b) {
     a /= b;
     return a;
-}
\ No newline at end of file
+}
+
+std::ostream& operator<<(std::ostream& out, const BigFloat& x) {
+    return out << x.toString();
+}
@@ -0,0 +1,146 @@
+#include "tiny_test.hpp"
+#include "biginteger.h"
+#include "random.hpp"
+
+using testing::make_pretty_test;
+using testing::TestGroup;
+
+
+std::string rounded(std::string_view text, size_t precision, RoundingMode mode) {
+    return BigFloat(text, precision, mode).toString();
+}
+
+std::string rounded(const Rational& value, size_t precision, RoundingMode mode) {
+    return BigFloat(value, precision, mode).toString();
+}
+
+// One unit in the last of precision digits of a positive x is at most x / 10^(precision - 1).
+Rational lastUnitBound(const Rational& x, size_t precision) {
+    BigInteger scale = 1;
+    scale.multiply_pow10(precision - 1);
+    return x / Rational(scale);
+}
+
+template <typename F>
+bool throwsInvalidArgument(F function) {
+    try {
+        function();
+    } catch (const std::invalid_argument&) {
+        return true;
+    }
+    return false;
+}
+
+TestGroup all_tests[] = {
+    TestGroup("Rounding",
+        make_pretty_test("nearest even", [](auto& test) {
+            test.check(rounded("2.5", 1, RoundingMode::NearestEven) == "2");
+            test.check(rounded("3.5", 1, RoundingMode::NearestEven) == "4");
+            test.check(rounded("-2.5", 1, RoundingMode::NearestEven) == "-2");
+            test.check(rounded("2.50001", 1, RoundingMode::NearestEven) == "3");
+            test.check(rounded("2.49999", 1, RoundingMode::NearestEven) == "2");
+            test.check(rounded("1234.5", 4, RoundingMode::NearestEven) == "1234");
+            test.check(rounded("9.96", 2, RoundingMode::NearestEven) == "10");
+        }),
+
+        make_pretty_test("directed modes", [](auto& test) {
+            for (const char* text : {"1.21", "1.29", "-1.21", "-1.29", "1.25", "-1.25"}) {
+                std::string_view value = text;
+                bool negative = value[0] == '-';
+                std::string sign = negative ? "-" : "";
+                test.check(rounded(value, 2, RoundingMode::TowardZero) == sign + "1.2");
+                test.check(rounded(value, 2, RoundingMode::Down) == sign + (negative ? "1.3" : "1.2"));
+                test.check(rounded(value, 2, RoundingMode::Up) == sign + (negative ? "1.2" : "1.3"));
+            }
+            test.check(rounded("1.2", 2, RoundingMode::Up) == "1.2");
+            test.check(rounded("-1.2", 2, RoundingMode::Down) == "-1.2");
+            test.check(rounded("999.1", 3, RoundingMode::Up) == "1e3");
+            test.check(rounded("-999.1", 3, RoundingMode::Down) == "-1e3");
+        }),
+
+        make_pretty_test("sticky digits", [](auto& test) {
+            std::string tail = "1" + std::string(200, '0') + "1";
+            test.check(rounded("2.5" + std::string(300, '0') + "1", 1, RoundingMode::NearestEven) == "3");
+            test.check(rounded("2." + tail, 2, RoundingMode::Up) == "2.2");
+            test.check(rounded("-2." + tail, 2, RoundingMode::Down) == "-2.2");
+            test.check(rounded("2." + tail, 2, RoundingMode::TowardZero) == "2.1");
+        })
+    ),
+
+    TestGroup("Long operands",
+        make_pretty_test("quotients", [](auto& test) {
+            const size_t precision = 1500;
+            for (size_t den_digits : {size_t{5}, size_t{60}, size_t{700}, size_t{1400}}) {
+                BigInteger a(randomDigits(1200, false));
+                BigInteger b(randomDigits(den_digits, false));
+                BigFloat quotient = BigFloat(a, precision, RoundingMode::TowardZero) / BigFloat(b, precision);
+                Rational exact(a, b);
+                Rational truncated = quotient.toRational();
+                test.check(truncated <= exact && exact - truncated < lastUnitBound(truncated, precision));
+            }
+        }),
+
+        make_pretty_test("square roots", [](auto& test) {
+            const size_t precision = 3100;
+            for (size_t digits : {size_t{1}, size_t{40}, size_t{1000}, size_t{3001}}) {
+                BigInteger n(randomDigits(digits, false));
+                Rational r = sqrt(BigFloat(n, precision, RoundingMode::TowardZero)).toRational();
+                Rational above = r + lastUnitBound(r, precision);
+                test.check(r * r <= Rational(n) && above * above > Rational(n));
+            }
+            BigInteger root = 1;
+            root.multiply_pow10(2000);
+            test.check(sqrt(BigFloat(root * root, precision)).toRational() == Rational(root));
+        })
+    ),
+
+    TestGroup("Conversions",
+        make_pretty_test("from Rational", [](auto& test) {
+            Rational third(BigInteger(1), BigInteger(3));
+            Rational two_thirds(BigInteger(-2), BigInteger(3));
+            test.check(rounded(third, 10, RoundingMode::NearestEven) == "0.3333333333");
+            test.check(rounded(third, 10, RoundingMode::Up) == "0.3333333334");
+            test.check(rounded(two_thirds, 3, RoundingMode::NearestEven) == "-0.667");
+            test.check(rounded(two_thirds, 3, RoundingMode::TowardZero) == "-0.666");
+            test.check(rounded(two_thirds, 3, RoundingMode::Down) == "-0.667");
+            test.check(rounded(two_thirds, 3, RoundingMode::Up) == "-0.666");
+            test.check(rounded(Rational(BigInteger(1), BigInteger(8)), 5, RoundingMode::NearestEven) == "0.125");
+            test.check(rounded(Rational(BigInteger(5), BigInteger(2)), 1, RoundingMode::NearestEven) == "2");
+        }),
+
+        make_pretty_test("to Rational", [](auto& test) {
+            test.check(BigFloat("0.125").toRational() == Rational(BigInteger(1), BigInteger(8)));
+            test.check(BigFloat("-1.5e3").toRational() == Rational(BigInteger(-1500)));
+            test.check(BigFloat("0").toRational() == Rational(BigInteger(0)));
+            for (int i = 0; i < 50; ++i) {
+                std::string digits = randomDigits(40);
+                std::string text = digits + "e" + std::to_string(static_cast<int>(generator() % 61) - 30);
+                BigFloat value(text, 60);
+                test.check(BigFloat(value.toRational(), 60) == value);
+            }
+        }),
+
+        make_pretty_test("decimal strings", [](auto& test) {
+            test.check(BigFloat("1.25e-3").toString() == "0.00125");
+            test.check(BigFloat("+12").toString() == "12");
+            test.check(BigFloat("-0.5").toString() == "-0.5");
+            test.check(BigFloat("12.e+2").toString() == "1200");
+            test.check(BigFloat(".5").toString() == "0.5");
+            test.check(BigFloat("1e60").toString() == "1e60");
+            test.check(BigFloat("1.5e-10").toString() == "1.5e-10");
+            test.check(BigFloat("000123.4500").toString() == "123.45");
+            for (const char* text : {"", "-", ".", "1.2.3", "1e", "1e+", "12a", "1e5x", " 1", "\xb2"}) {
+                test.check(throwsInvalidArgument([text] { BigFloat value(text); }));
+            }
+        })
+    )
+};
+
+
+int main() {
+    bool success = true;
+    for (auto& group : all_tests) {
+        success &= group.run();
+    }
+    return success ? 0 : 1;
+}
@@ -0,0 +1,216 @@
+#include "tiny_test.hpp"
+#include "biginteger.h"
+#include "reference.hpp"
+
+using testing::make_pretty_test;
+using testing::TestGroup;
+
+
+// a * b against GMP; operands are decimal strings.
+bool matchesReference(const std::string& a, const std::string& b) {
+    Reference product;
+    mpz_mul(product.value, Reference(a).value, Reference(b).value);
+    bool same = (BigInteger(a) * BigInteger(b)).toString() == product.toString();
+    if (!same) {
+        std::cout << a.size() << "-digit * " << b.size() << "-digit product differs\n";
+    }
+    return same;
+}
+
+// Every check compares BigInteger against GMP on the same random operands. Built plainly this validates the native
+// kernels against GMP; built with BIGINTEGER_USE_GMP it validates the backend's API semantics around the mpz calls.
+TestGroup all_tests[] = {
+    TestGroup("Crosscheck",
+        make_pretty_test("multiplication", [](auto& test) {
+            for (int i = 0; i < 200; ++i) {
+                std::string a = randomNumber(randomSize());
+                std::string b = randomNumber(randomSize());
+                Reference product;
+                mpz_mul(product.value, Reference(a).value, Reference(b).value);
+                if (!test.check((BigInteger(a) * BigInteger(b)).toString() == product.toString())) {
+                    std::cout << a << " * " << b << '\n';
+                }
+            }
+        }),
+
+        // All-9s operands push the transform's rounding error highest. From about 7.8 million digits each the
+        // direct transform is ruled out and the limbs are split into base-32 pieces; past that only the schoolbook
+        // loop is left, which no operand fitting in memory reaches. crosscheck_fft_fallback lowers the error bound
+        // so that the random operands above take both of those paths, and skips these sizes, which would then all
+        // run schoolbook.
+        make_pretty_test("transform error fallbacks", [](auto& test) {
+#ifndef BIGINTEGER_FFT_ERROR_LIMIT
+            for (size_t digits : {size_t{200000}, size_t{8000000}}) {
+                std::string nines(digits, '9');
+                test.check(matchesReference(nines, nines));
+                test.check(matchesReference("-" + nines, nines.substr(digits / 3)));
+            }
+#else
+            for (size_t digits : {size_t{300}, size_t{5000}}) {
+                std::string nines(digits, '9');
+                test.check(matchesReference(nines, nines));
+                test.check(matchesReference("-" + nines, nines.substr(digits / 3)));
+            }
+#endif
+        }),
+
+        // Operands of equal length in digits, with their product's transform length in points: above FFT_CACHE_BLOCK
+        // (4096 points) the transform recurses into cache-sized blocks instead of running breadth-first, and lengths
+        // of 3 * 2^k start with a radix-3 split into power-of-two blocks.
+        make_pretty_test("transform lengths", [](auto& test) {
+            const size_t sizes[] = {
+                5400,   // 4096
+                7500,   // 6144 = 3 * 2048
+                12000,  // 8192
+                15000,  // 12288 = 3 * 4096
+                30000,  // 24576 = 3 * 8192
+                39000,  // 32768
+            };
+            for (size_t digits : sizes) {
+                test.check(matchesReference(randomDigits(digits), randomDigits(digits)));
+                test.check(matchesReference(std::string(digits, '9'), std::string(digits, '9')));
+            }
+        }),
+
+        // A longer operand at least 8 times the shorter, which has more than 32 limbs, is cut into chunks that share
+        // one transform in pairs. Lengths in digits: exactly 8 times, an odd chunk count leaving the last one
+        // unpaired, and many chunks against short and long multipliers.
+        make_pretty_test("chunked products", [](auto& test) {
+            const std::pair<size_t, size_t> sizes[] = {{816, 100}, {1000, 100}, {300000, 500}, {200000, 3000}};
+            for (auto [longer, shorter] : sizes) {
+                test.check(matchesReference(randomDigits(longer), randomDigits(shorter)));
+                test.check(matchesReference(randomDigits(shorter), randomDigits(longer)));
+                test.check(matchesReference(std::string(longer, '9'), "-" + std::string(shorter, '9')));
+            }
+        }),
+
+        make_pretty_test("division", [](auto& test) {
+            for (int i = 0; i < 200; ++i) {
+                std::string a = randomNumber(randomSize());
+                std::string b = randomNumber(std::min<size_t>(randomSize(), 2000));
+                Reference div;
+                Reference mod;
+                mpz_tdiv_qr(div.value, mod.value, Reference(a).value, Reference(b).value);
+                auto [big_div, big_mod] = BigInteger(a).div_mod(BigInteger(b));
+                bool same = big_div.toString() == div.toString() && big_mod.toString() == mod.toString();
+                same &= BigInteger(a) / BigInteger(b) == big_div && BigInteger(a) % BigInteger(b) == big_mod;
+                if (!test.check(same)) {
+                    std::cout << a << " / " << b << '\n';
+                }
+            }
+            // Lengths around the points where conversions to and from GMP split the limbs.
+            for (int digits : {191, 192, 193, 383, 384, 385, 768, 769, 1537, 3073}) {
+                std::string a = randomDigits(static_cast<size_t>(digits));
+                for (const char* b : {"1", "-1", "7", "999", "1000", "1001"}) {
+                    Reference div;
+                    Reference mod;
+                    mpz_tdiv_qr(div.value, mod.value, Reference(a).value, Reference(b).value);
+                    auto [big_div, big_mod] = BigInteger(a).div_mod(BigInteger(b));
+                    test.check(big_div.toString() == div.toString() && big_mod.toString() == mod.toString());
+                }
+            }
+            auto [zero_div, zero_mod] = BigInteger(0).div_mod(BigInteger(randomNumber(100)));
+            test.check(zero_div == 0 && zero_mod == 0);
+        }),
+
+        make_pretty_test("gcd", [](auto& test) {
+            for (int i = 0; i < 100; ++i) {
+                std::string factor = randomNumber(randomSize() / 4, false);
+                std::string a = (BigInteger(randomNumber(400)) * BigInteger(factor)).toString();
+                std::string b = (BigInteger(randomNumber(400)) * BigInteger(factor)).toString();
+                Reference g;
+                mpz_gcd(g.value, Reference(a).value, Reference(b).value);
+                if (!test.check(gcd(BigInteger(a), BigInteger(b)).toString() == g.toString())) {
+                    std::cout << "gcd(" << a << ", " << b << ")\n";
+                }
+            }
+        }),
+
+        make_pretty_test("multiply_pow10", [](auto& test) {
+            for (int i = 0; i < 100; ++i) {
+                std::string a = randomNumber(randomSize());
+                unsigned long power = generator() % 5000;
+                Reference scaled;
+                mpz_ui_pow_ui(scaled.value, 10, power);
+                mpz_mul(scaled.value, scaled.value, Reference(a).value);
+                BigInteger big(a);
+                big.multiply_pow10(power);
+                test.check(big.toString() == scaled.toString());
+            }
+        }),
+
+        make_pretty_test("toString", [](auto& test) {
+            for (int i = 0; i < 100; ++i) {
+                std::string a = randomNumber(randomSize());
+                BigInteger big(a);
+                Reference reference(a);
+                for (int base : {2, 7, 10, 16, 36}) {
+                    test.check(big.toString(base) == reference.toString(base));
+                    test.check(BigInteger(reference.toString(base), base) == big);
+                }
+            }
+            for (int base : {-2, 0, 1, 37}) {
+                bool thrown = false;
+                try {
+                    (void)BigInteger(12345).toString(base);
+                } catch (const std::invalid_argument&) {
+                    thrown = true;
+                }
+                test.check(thrown);
+            }
+        }),
+
+        make_pretty_test("literal", [](auto& test) {
+            test.check(123456789012345678901234567890_bi == BigInteger("123456789012345678901234567890"));
+            test.check((-98765432109876543210_bi).toString() == Reference("-98765432109876543210").toString());
+            test.check(0_bi == BigInteger(0));
+        }),
+
+        make_pretty_test("rational", [](auto& test) {
+            for (int i = 0; i < 100; ++i) {
+                std::string a = randomNumber(randomSize() / 4);
+                std::string b = randomNumber(randomSize() / 4, false);
+                mpq_t reference;
+                mpq_init(reference);
+                mpz_set(mpq_numref(reference), Reference(a).value);
+                mpz_set(mpq_denref(reference), Reference(b).value);
+                mpq_canonicalize(reference);
+                std::string expected(mpz_sizeinbase(mpq_numref(reference), 10) +
+                                     mpz_sizeinbase(mpq_denref(reference), 10) + 3, '\0');
+                mpq_get_str(expected.data(), 10, reference);
+                expected.resize(expected.find('\0'));
+                mpq_clear(reference);
+
+                Rational rational = Rational(BigInteger(a)) / Rational(BigInteger(b));
+                if (!test.check(rational.toString() == expected)) {
+                    std::cout << a << " / " << b << '\n';
+                }
+
+                size_t precision = generator() % 50;
+                Reference decimal;
+                mpz_ui_pow_ui(decimal.value, 10, precision);
+                mpz_mul(decimal.value, decimal.value, Reference(a).value);
+                mpz_abs(decimal.value, decimal.value);
+                mpz_tdiv_q(decimal.value, decimal.value, Reference(b).value);
+                std::string digits = decimal.toString();
+                digits.insert(0, precision + 1 > digits.size() ? precision + 1 - digits.size() : 0, '0');
+                if (precision) {
+                    digits.insert(digits.size() - precision, ".");
+                }
+                if (a[0] == '-' && digits.find_first_not_of("0.") != std::string::npos) {
+                    digits.insert(0, "-");
+                }
+                test.check(rational.asDecimal(precision) == digits);
+            }
+        })
+    )
+};
+
+
+int main() {
+    bool success = true;
+    for (auto& group : all_tests) {
+        success &= group.run();
+    }
+    return success ? 0 : 1;
+}
@@ -0,0 +1,104 @@
+#include "tiny_test.hpp"
+#include "biginteger.h"
+#include "random.hpp"
+
+using testing::make_pretty_test;
+using testing::TestGroup;
+
+
+BigInteger positive(size_t digits) {
+    return BigInteger(randomDigits(digits, false));
+}
+
+BigInteger power(long long base, int exponent) {
+    BigInteger result = 1;
+    while (exponent--) {
+        result *= base;
+    }
+    return result;
+}
+
+// Divides q * b by b with every sign combination and compares with both the known quotient and operator/.
+bool recoversQuotient(const BigInteger& q, const BigInteger& b) {
+    bool same = true;
+    for (int signs = 0; signs < 4; ++signs) {
+        BigInteger divisor = signs & 1 ? -b : b;
+        BigInteger expected = signs & 2 ? -q : q;
+        BigInteger product = expected * divisor;
+        BigInteger quotient = divexact(product, divisor);
+        same &= quotient == expected && quotient == product / divisor;
+    }
+    if (!same) {
+        std::cout << "divexact(" << q * b << ", " << b << ")\n";
+    }
+    return same;
+}
+
+// Sizes are in limbs of three decimal digits. henselQuotient runs the schoolbook loop while the shorter of the
+// divisor and the quotient fits in 1024 limbs and a Newton-lifted inverse above that.
+TestGroup all_tests[] = {
+    TestGroup("divexact",
+        make_pretty_test("Hensel schoolbook and Newton", [](auto& test) {
+            const size_t sizes[] = {1, 2, 1023, 1024, 1025, 1100};
+            for (size_t limbs : sizes) {
+                test.check(recoversQuotient(positive(3 * limbs), positive(3 * limbs)));
+            }
+            for (size_t limbs : sizes) {
+                test.check(recoversQuotient(positive(3 * limbs), positive(5)));
+                test.check(recoversQuotient(positive(5), positive(3 * limbs)));
+            }
+        }),
+
+        make_pretty_test("small powers of 2 and 5", [](auto& test) {
+            BigInteger q = positive(600);
+            BigInteger odd(randomDigits(300, false) + "1");
+            for (int exponent : {1, 2, 3, 4, 9, 23, 24}) {
+                test.check(recoversQuotient(q, power(2, exponent) * odd));
+                test.check(recoversQuotient(q, power(5, exponent) * odd));
+                test.check(recoversQuotient(q, power(2, exponent) * power(5, 24 - exponent) * odd));
+            }
+            test.check(recoversQuotient(q, power(2, 24)));
+            test.check(recoversQuotient(q, power(5, 24) * BigInteger("1000000")));
+        }),
+
+        make_pretty_test("large powers of 2 and 5", [](auto& test) {
+            BigInteger q = positive(600);
+            BigInteger odd(randomDigits(300, false) + "3");
+            for (int exponent : {25, 26, 40, 100, 200}) {
+                test.check(recoversQuotient(q, power(2, exponent) * odd));
+                test.check(recoversQuotient(q, power(5, exponent) * odd));
+                test.check(recoversQuotient(q, power(2, exponent)));
+                test.check(recoversQuotient(positive(4000), power(5, exponent) * odd));
+            }
+            test.check(recoversQuotient(q, power(5, 150)));
+            test.check(recoversQuotient(positive(4000), power(2, 200) * power(5, 150) * odd));
+            test.check(recoversQuotient(q, power(2, 150) * power(5, 200) * BigInteger("1000000")));
+            test.check(recoversQuotient(power(2, 300), power(2, 200)));
+            test.check(recoversQuotient(power(5, 10), power(5, 150) * odd));
+        }),
+
+        make_pretty_test("zero and units", [](auto& test) {
+            BigInteger b = positive(100);
+            test.check(divexact(BigInteger(0), b) == 0);
+            test.check(divexact(b, b) == 1);
+            test.check(divexact(b, -b) == -1);
+            test.check(divexact(-b, BigInteger(1)) == -b);
+            bool thrown = false;
+            try {
+                divexact(b, BigInteger(0));
+            } catch (const std::domain_error&) {
+                thrown = true;
+            }
+            test.check(thrown);
+        })
+    )
+};
+
+
+int main() {
+    bool success = true;
+    for (auto& group : all_tests) {
+        success &= group.run();
+    }
+    return success ? 0 : 1;
+}
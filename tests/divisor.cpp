@@ -0,0 +1,91 @@
+#include "tiny_test.hpp"
+#include "biginteger.h"
+#include "reference.hpp"
+
+using testing::make_pretty_test;
+using testing::TestGroup;
+
+
+// Divisor picks a path by the divisor's limb count (three decimal digits each): the single-limb magic multiply,
+// a plain reciprocal up to 16 limbs, Newton refinement above that, and block long division once the dividend
+// exceeds twice the divisor. The sizes below straddle each switch.
+bool matchesReference(const std::string& a, const std::string& b) {
+    Divisor divisor{BigInteger(b)};
+    auto [div, mod] = divisor.div_mod(BigInteger(a));
+    Reference quotient;
+    Reference remainder;
+    mpz_tdiv_qr(quotient.value, remainder.value, Reference(a).value, Reference(b).value);
+    bool same = div.toString() == quotient.toString() && mod.toString() == remainder.toString();
+    if (!same) {
+        std::cout << a << " / " << b << "\n";
+    }
+    return same;
+}
+
+TestGroup all_tests[] = {
+    TestGroup("Divisor",
+        make_pretty_test("single limb", [](auto& test) {
+            const size_t lengths[] = {1, 2, 3, 6, 7, 300};
+            for (const char* b : {"1", "-1", "7", "999", "-999", "10", "100"}) {
+                for (size_t length : lengths) {
+                    test.check(matchesReference(randomDigits(length), b));
+                }
+                test.check(matchesReference("0", b));
+            }
+        }),
+
+        make_pretty_test("reciprocal and Newton thresholds", [](auto& test) {
+            const size_t divisor_limbs[] = {2, 3, 15, 16, 17, 18, 33, 34, 100};
+            for (size_t limbs : divisor_limbs) {
+                std::string b = randomDigits(3 * limbs);
+                for (size_t length : {3 * limbs - 1, 3 * limbs, 6 * limbs - 1, 6 * limbs, 6 * limbs + 1,
+                                      9 * limbs, 40 * limbs}) {
+                    test.check(matchesReference(randomDigits(length), b));
+                }
+            }
+        }),
+
+        make_pretty_test("trailing zero limbs", [](auto& test) {
+            const size_t divisor_limbs[] = {2, 16, 17, 40};
+            for (size_t limbs : divisor_limbs) {
+                for (size_t zeros : {size_t{1}, limbs / 2, limbs - 1}) {
+                    std::string tail(3 * zeros, '0');
+                    std::string b = randomDigits(3 * (limbs - zeros)) + tail;
+                    for (size_t length : {6 * limbs, 6 * limbs + 1, 20 * limbs}) {
+                        test.check(matchesReference(randomDigits(length), b));
+                        test.check(matchesReference(randomDigits(length - tail.size()) + tail, b));
+                    }
+                }
+            }
+        }),
+
+        make_pretty_test("exact multiples", [](auto& test) {
+            const size_t divisor_limbs[] = {1, 16, 17, 64};
+            for (size_t limbs : divisor_limbs) {
+                std::string b = randomDigits(3 * limbs);
+                BigInteger product = BigInteger(b) * BigInteger(randomDigits(3 * limbs + 5));
+                test.check(matchesReference(product.toString(), b));
+                test.check(matchesReference((product - 1).toString(), b));
+            }
+        }),
+
+        make_pretty_test("zero divisor", [](auto& test) {
+            bool thrown = false;
+            try {
+                Divisor divisor{BigInteger(0)};
+            } catch (const std::domain_error&) {
+                thrown = true;
+            }
+            test.check(thrown);
+        })
+    )
+};
+
+
+int main() {
+    bool success = true;
+    for (auto& group : all_tests) {
+        success &= group.run();
+    }
+    return success ? 0 : 1;
+}
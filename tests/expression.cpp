@@ -0,0 +1,220 @@
+#include "tiny_test.hpp"
+#include "biginteger.h"
+#include "random.hpp"
+
+using testing::make_pretty_test;
+using testing::TestGroup;
+
+
+// Operands from one limb to past the transform threshold, of either sign.
+std::vector<BigInteger> operands() {
+    std::vector<BigInteger> result = {BigInteger(0), BigInteger(1), BigInteger(-999)};
+    for (size_t digits : {size_t{4}, size_t{60}, size_t{300}, size_t{2000}}) {
+        result.emplace_back(randomDigits(digits));
+    }
+    return result;
+}
+
+TestGroup all_tests[] = {
+    TestGroup("Expression templates",
+        make_pretty_test("match eager results", [](auto& test) {
+            std::vector<BigInteger> values = operands();
+            for (const BigInteger& a : values) {
+                for (const BigInteger& b : values) {
+                    const BigInteger& c = values[generator() % values.size()];
+                    const BigInteger& d = values[generator() % values.size()];
+                    BigInteger eager_sum = a * b + c * d;
+                    BigInteger eager_difference = a * b - c * d;
+                    BigInteger sum = lazy(a) * b + lazy(c) * d;
+                    BigInteger difference = lazy(a) * b - lazy(c) * d;
+                    BigInteger mixed = lazy(a) * b + c * d;
+                    BigInteger negated = -(lazy(a) * b);
+                    test.check(sum == eager_sum && difference == eager_difference && mixed == eager_sum);
+                    test.check(negated == -(a * b));
+                    test.check(BigInteger(lazy(a) * b * c) == a * b * c);
+                }
+            }
+        }),
+
+        make_pretty_test("fused multiply-add", [](auto& test) {
+            std::vector<BigInteger> values = operands();
+            for (const BigInteger& a : values) {
+                for (const BigInteger& b : values) {
+                    const BigInteger& c = values[generator() % values.size()];
+                    BigInteger sum = c;
+                    sum += lazy(a) * b;
+                    BigInteger difference = c;
+                    difference -= lazy(a) * b;
+                    test.check(sum == c + a * b && difference == c - a * b);
+
+                    BigInteger chained = c;
+                    chained += lazy(a) * b - lazy(b) * c;
+                    test.check(chained == c + a * b - b * c);
+                }
+            }
+        }),
+
+        make_pretty_test("destination aliases an operand", [](auto& test) {
+            std::vector<BigInteger> values = operands();
+            for (const BigInteger& a : values) {
+                for (const BigInteger& b : values) {
+                    BigInteger x = a;
+                    x = lazy(x) * b + lazy(b) * x;
+                    test.check(x == 2 * a * b);
+
+                    x = a;
+                    x = lazy(b) * b - lazy(x) * x;
+                    test.check(x == b * b - a * a);
+
+                    x = a;
+                    x += lazy(x) * b;
+                    test.check(x == a + a * b);
+
+                    x = a;
+                    x -= lazy(b) * x;
+                    test.check(x == a - b * a);
+
+                    x = a;
+                    x += lazy(x) * x;
+                    test.check(x == a + a * a);
+                }
+            }
+        })
+    ),
+
+    TestGroup("Multiply-accumulate",
+        make_pretty_test("addmul and submul", [](auto& test) {
+            std::vector<BigInteger> values = operands();
+            for (const BigInteger& a : values) {
+                for (const BigInteger& b : values) {
+                    for (const BigInteger& c : values) {
+                        BigInteger sum = c;
+                        addmul(sum, a, b);
+                        BigInteger difference = c;
+                        submul(difference, a, b);
+                        test.check(sum == c + a * b && difference == c - a * b);
+                    }
+                }
+            }
+            BigInteger x(1000);
+            submul(x, BigInteger(-1), BigInteger(-1001));
+            test.check(x == -1);
+            addmul(x, BigInteger(1), BigInteger(1));
+            test.check(x == 0 && x.toString() == "0");
+            addmul(x, BigInteger(-3), BigInteger(4));
+            test.check(x == -12);
+        }),
+
+        make_pretty_test("addmul_ui and submul_ui", [](auto& test) {
+            std::vector<BigInteger> values = operands();
+            const unsigned long long factors[] = {0, 1, 999, 1000, 123456789,
+                                                  std::numeric_limits<unsigned long long>::max()};
+            for (const BigInteger& a : values) {
+                for (const BigInteger& c : values) {
+                    for (unsigned long long factor : factors) {
+                        BigInteger b(std::to_string(factor));
+                        BigInteger sum = c;
+                        addmul_ui(sum, a, factor);
+                        BigInteger difference = c;
+                        submul_ui(difference, a, factor);
+                        test.check(sum == c + a * b && difference == c - a * b);
+                    }
+                }
+            }
+            BigInteger x(-5);
+            addmul_ui(x, BigInteger(1), 7);
+            test.check(x == 2);
+            submul_ui(x, BigInteger(1), 2);
+            test.check(x == 0);
+            submul_ui(x, BigInteger(-2), 3);
+            test.check(x == 6);
+        }),
+
+        make_pretty_test("accumulator aliases an operand", [](auto& test) {
+            std::vector<BigInteger> values = operands();
+            for (const BigInteger& a : values) {
+                for (const BigInteger& b : values) {
+                    BigInteger x = a;
+                    addmul(x, x, b);
+                    test.check(x == a + a * b);
+                    x = a;
+                    submul(x, b, x);
+                    test.check(x == a - b * a);
+                    x = a;
+                    addmul(x, x, x);
+                    test.check(x == a + a * a);
+                    x = a;
+                    submul(x, x, x);
+                    test.check(x == a - a * a);
+                    x = a;
+                    addmul_ui(x, x, 12345);
+                    test.check(x == a * 12346);
+                    x = a;
+                    submul_ui(x, x, 1);
+                    test.check(x == 0);
+                }
+            }
+        }),
+
+        make_pretty_test("dot", [](auto& test) {
+            std::vector<BigInteger> values = operands();
+            for (int i = 0; i < 20; ++i) {
+                std::vector<BigInteger> left;
+                std::vector<BigInteger> right;
+                BigInteger expected;
+                size_t length = 1 + generator() % 12;
+                for (size_t j = 0; j < length; ++j) {
+                    left.push_back(values[generator() % values.size()]);
+                    right.push_back(values[generator() % values.size()]);
+                    expected += left.back() * right.back();
+                }
+                test.check(dot(left, right) == expected);
+                right.push_back(BigInteger(randomDigits(50)));
+                test.check(dot(left, right) == expected && dot(right, left) == expected);
+            }
+
+            // The running sum changes sign after every term: 1000, -400, 500, -500.
+            std::vector<BigInteger> left = {BigInteger(10), BigInteger(-7), BigInteger(3), BigInteger(-1)};
+            std::vector<BigInteger> right = {BigInteger(100), BigInteger(200), BigInteger(300), BigInteger(1000)};
+            test.check(dot(left, right) == -500);
+            std::array<BigInteger, 2> cancel = {BigInteger(randomDigits(300, false)), BigInteger(1)};
+            std::array<BigInteger, 2> weights = {BigInteger(1), -cancel[0]};
+            BigInteger zero = dot(cancel, weights);
+            test.check(zero == 0 && zero.toString() == "0");
+            test.check(dot(std::vector<BigInteger>(), values) == 0);
+        })
+    ),
+
+    TestGroup("Rational accumulation",
+        make_pretty_test("operator+= and operator-=", [](auto& test) {
+            for (int i = 0; i < 100; ++i) {
+                BigInteger p(randomNumber(200));
+                BigInteger q(randomNumber(200, false));
+                BigInteger r(randomNumber(200));
+                BigInteger s(randomNumber(200, false));
+                Rational sum(p, q);
+                sum += Rational(r, s);
+                test.check(sum == Rational(p * s + r * q, q * s));
+                Rational difference(p, q);
+                difference -= Rational(r, s);
+                test.check(difference == Rational(p * s - r * q, q * s));
+
+                Rational doubled(p, q);
+                doubled += doubled;
+                test.check(doubled == Rational(2 * p, q));
+                Rational zero(p, q);
+                zero -= zero;
+                test.check(zero == Rational(BigInteger(0)));
+            }
+        })
+    )
+};
+
+
+int main() {
+    bool success = true;
+    for (auto& group : all_tests) {
+        success &= group.run();
+    }
+    return success ? 0 : 1;
+}
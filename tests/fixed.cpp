@@ -0,0 +1,105 @@
+#include "tiny_test.hpp"
+#include "biginteger.h"
+#include "random.hpp"
+
+using testing::make_pretty_test;
+using testing::TestGroup;
+
+
+using Fixed64 = FixedBigInt<64>;
+using Fixed128 = FixedBigInt<128>;
+
+constexpr Fixed128 x = 123456789012345678901234567890_fbi;
+constexpr Fixed128 y = Fixed128(98765432109876543210_fbi);
+constexpr Fixed64 max64 = (Fixed64(1) << 63) - Fixed64(1);
+
+// Literals take the narrowest multiple of 32 bits that holds the value and a sign bit.
+static_assert(std::is_same_v<decltype(7_fbi), FixedBigInt<32>>);
+static_assert(std::is_same_v<decltype(0xffffffff_fbi), FixedBigInt<64>>);
+static_assert(std::is_same_v<decltype(123456789012345678901234567890_fbi), FixedBigInt<128>>);
+static_assert(0x1F_fbi == FixedBigInt<32>(31) && 0b101_fbi == FixedBigInt<32>(5) && 017_fbi == FixedBigInt<32>(15));
+static_assert(1'000'000_fbi == FixedBigInt<32>(1000000));
+static_assert(Fixed128(0xffffffffffffffff_fbi) + Fixed128(1) == Fixed128(1) << 64);
+
+static_assert(Fixed128(123456789) + Fixed128(987654321) == Fixed128(1111111110));
+static_assert(Fixed128(5) - Fixed128(12) == Fixed128(-7) && -Fixed128(-7) == Fixed128(7));
+static_assert(x + y - y == x && x - x == Fixed128());
+static_assert(++Fixed128(-1) == Fixed128() && --Fixed128() == Fixed128(-1));
+
+static_assert(Fixed128(1LL << 50) * Fixed128(1LL << 50) == Fixed128(1) << 100);
+static_assert(Fixed128(-3) * Fixed128(7) == Fixed128(-21) && Fixed128(-3) * Fixed128(-7) == Fixed128(21));
+static_assert(x * Fixed128(0) == Fixed128() && x * Fixed128(1) == x);
+
+static_assert(x / y == Fixed128(1249999988) && x % y == Fixed128(60185185207253086410_fbi));
+static_assert(-x / y == Fixed128(-1249999988) && -x % y == -Fixed128(60185185207253086410_fbi));
+static_assert(Fixed128(-7) / Fixed128(2) == Fixed128(-3) && Fixed128(-7) % Fixed128(2) == Fixed128(-1));
+static_assert(Fixed128(7) / Fixed128(-2) == Fixed128(-3) && Fixed128(7) % Fixed128(-2) == Fixed128(1));
+static_assert(((Fixed128(1) << 100) + Fixed128(5)) % (Fixed128(1) << 40) == Fixed128(5));
+static_assert(((Fixed128(1) << 100) + Fixed128(5)) / (Fixed128(1) << 40) == Fixed128(1) << 60);
+static_assert(y / x == Fixed128() && y % x == y);
+
+static_assert((Fixed128(1) << 127) < Fixed128() && (Fixed128(1) << 127).isNegative());
+static_assert((Fixed128(0x1234) << 68) >> 68 == Fixed128(0x1234));
+static_assert(Fixed128(-8) >> 1 == Fixed128(-4) && Fixed128(-1) >> 200 == Fixed128(-1));
+static_assert(Fixed128(5) << 128 == Fixed128() && Fixed128(3) >> 128 == Fixed128());
+static_assert((x >> 33) == x / (Fixed128(1) << 33));
+
+// Arithmetic wraps modulo 2^Bits like unsigned integers, read back as two's complement.
+static_assert(max64 + Fixed64(1) == Fixed64(std::numeric_limits<long long>::min()));
+static_assert(Fixed64(std::numeric_limits<long long>::min()) - Fixed64(1) == max64);
+static_assert((Fixed64(1) << 32) * (Fixed64(1) << 32) == Fixed64());
+static_assert((Fixed128(1) << 127) * Fixed128(2) == Fixed128());
+static_assert((Fixed128(1) << 127) + (Fixed128(1) << 127) == Fixed128());
+static_assert(max64 * max64 == Fixed64(1));
+
+static_assert(Fixed128(-5) < Fixed128(3) && Fixed128(3) < x && -x < Fixed128(-5));
+static_assert(FixedBigInt<256>(Fixed128(-5)) == FixedBigInt<256>(-5));
+
+// BigInteger modulo 2^Bits in the symmetric range, for comparing wrapped results.
+BigInteger wrapped(const BigInteger& value, size_t bits) {
+    BigInteger modulus = 1;
+    for (size_t i = 0; i < bits; ++i) {
+        modulus *= 2;
+    }
+    BigInteger half = modulus / 2;
+    BigInteger result = (value % modulus + modulus) % modulus;
+    return result >= half ? result - modulus : result;
+}
+
+TestGroup all_tests[] = {
+    TestGroup("FixedBigInt",
+        make_pretty_test("matches BigInteger", [](auto& test) {
+            for (int i = 0; i < 200; ++i) {
+                BigInteger a(randomNumber(70));
+                BigInteger b(randomNumber(35));
+                FixedBigInt<256> fa(a);
+                FixedBigInt<256> fb(b);
+                test.check(BigInteger(fa) == a && BigInteger(fb) == b);
+                test.check(BigInteger(fa + fb) == a + b && BigInteger(fa - fb) == a - b);
+                test.check(BigInteger(fa * fb) == wrapped(a * b, 256));
+                test.check(BigInteger(fa / fb) == a / b && BigInteger(fa % fb) == a % b);
+                test.check(BigInteger(FixedBigInt<128>(a)) == wrapped(a, 128));
+            }
+        }),
+
+        make_pretty_test("division by zero", [](auto& test) {
+            bool thrown = false;
+            try {
+                (void)(x / Fixed128());
+            } catch (const std::domain_error&) {
+                thrown = true;
+            }
+            test.check(thrown);
+            test.check(x.toString() == "123456789012345678901234567890");
+        })
+    )
+};
+
+
+int main() {
+    bool success = true;
+    for (auto& group : all_tests) {
+        success &= group.run();
+    }
+    return success ? 0 : 1;
+}
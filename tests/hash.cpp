@@ -0,0 +1,133 @@
+#include "tiny_test.hpp"
+#include "biginteger.h"
+#include "random.hpp"
+
+#include <sstream>
+#include <unordered_map>
+#include <unordered_set>
+
+using testing::make_pretty_test;
+using testing::TestGroup;
+
+
+// The same value reached through construction, parsing and arithmetic that leave different limb histories behind.
+std::vector<BigInteger> histories(const std::string& digits) {
+    BigInteger x(digits);
+    std::vector<BigInteger> result = {x};
+
+    std::istringstream in(digits);
+    in >> result.emplace_back();
+    result.emplace_back(x.toString(16), 16);
+
+    BigInteger factor(randomDigits(700));
+    result.push_back(x * factor / factor);
+    BigInteger grown = x;
+    grown += factor;
+    grown -= factor;
+    result.push_back(grown);
+    BigInteger shrunk = x * factor * factor;
+    shrunk /= factor;
+    shrunk /= factor;
+    result.push_back(shrunk);
+    BigInteger negated = -x;
+    negated.changeSign();
+    result.push_back(negated);
+    result.push_back(x + 0);
+    result.push_back((x - 1) + 1);
+    return result;
+}
+
+bool hashesAgree(const std::vector<BigInteger>& values) {
+    bool same = true;
+    for (const BigInteger& v : values) {
+        same = same && v == values[0] && v.hash() == values[0].hash() && v.hash(12345) == values[0].hash(12345) &&
+               std::hash<BigInteger>{}(v) == std::hash<BigInteger>{}(values[0]) &&
+               Hashed<BigInteger>(v) == Hashed<BigInteger>(values[0]);
+    }
+    if (!same) {
+        std::cout << "hashes of " << values[0] << " differ\n";
+    }
+    return same;
+}
+
+TestGroup all_tests[] = {
+    TestGroup("BigInteger hashing",
+        make_pretty_test("equal values hash equal", [](auto& test) {
+            for (const char* digits : {"0", "1", "-1", "999", "1000", "-123456789012345678901234567890"}) {
+                test.check(hashesAgree(histories(digits)));
+            }
+            for (int i = 0; i < 20; ++i) {
+                test.check(hashesAgree(histories(randomDigits(randomSize()))));
+            }
+
+            BigInteger a(randomDigits(500));
+            BigInteger zeros[] = {BigInteger(), BigInteger(0), BigInteger("-0"), a - a, -a + a, a * 0,
+                                  BigInteger(-5) + 5, BigInteger(7) % 7, BigInteger(-7) % 7, BigInteger(3) / -4};
+            test.check(hashesAgree(std::vector<BigInteger>(std::begin(zeros), std::end(zeros))));
+        }),
+
+        make_pretty_test("different values hash apart", [](auto& test) {
+            std::unordered_set<uint64_t> seen;
+            for (long long v = -1000; v <= 1000; ++v) {
+                seen.insert(BigInteger(v).hash());
+            }
+            test.check(seen.size() == 2001);
+
+            BigInteger x(randomDigits(3000, false));
+            test.check(x.hash() != (-x).hash() && x.hash() != (x + 1).hash());
+            test.check(x.hash(1) != x.hash(2) && x.hash() != x.hash(1));
+        }),
+
+        make_pretty_test("unordered containers", [](auto& test) {
+            std::unordered_map<BigInteger, int> counts;
+            std::unordered_set<Hashed<BigInteger>> cached;
+            std::vector<std::string> values;
+            for (int i = 0; i < 100; ++i) {
+                values.push_back(randomNumber(300));
+            }
+            for (const std::string& digits : values) {
+                for (const BigInteger& v : histories(digits)) {
+                    ++counts[v];
+                    cached.emplace(v);
+                }
+            }
+            size_t distinct = std::unordered_set<std::string>(values.begin(), values.end()).size();
+            test.check(counts.size() == distinct && cached.size() == distinct);
+            for (const std::string& digits : values) {
+                Hashed<BigInteger> key{BigInteger(digits)};
+                test.check(cached.contains(key) && key.value() == BigInteger(digits));
+                test.check(key.hash() == std::hash<BigInteger>{}(BigInteger(digits)));
+            }
+        })
+    ),
+
+    TestGroup("Rational hashing",
+        make_pretty_test("equal values hash equal", [](auto& test) {
+            for (int i = 0; i < 50; ++i) {
+                BigInteger p(randomNumber(200));
+                BigInteger q(randomNumber(200, false));
+                BigInteger k(randomNumber(100));
+                Rational r(p, q);
+                Rational scaled(p * k, q * k);
+                Rational negated(-p, -q);
+                Rational summed = r + Rational(k, q) - Rational(k, q);
+                for (const Rational& s : {scaled, negated, summed}) {
+                    test.check(s == r && s.hash() == r.hash() && std::hash<Rational>{}(s) == std::hash<Rational>{}(r));
+                    test.check(Hashed<Rational>(s) == Hashed<Rational>(r));
+                }
+            }
+            test.check(Rational(2, 4).hash() == Rational(1, 2).hash() && Rational(0, 5).hash() == Rational().hash());
+            test.check(Rational(1, 2).hash() != Rational(2, 1).hash());
+            test.check(Rational(1, 2).hash() != Rational(-1, 2).hash());
+        })
+    )
+};
+
+
+int main() {
+    bool success = true;
+    for (auto& group : all_tests) {
+        success &= group.run();
+    }
+    return success ? 0 : 1;
+}
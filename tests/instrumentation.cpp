@@ -0,0 +1,113 @@
+#include "tiny_test.hpp"
+#include "biginteger.h"
+
+#include <sstream>
+
+using testing::make_pretty_test;
+using testing::TestGroup;
+using bigint_stats::Operation;
+
+
+// Operands have 1, 4 or 7 digits, so they take 1, 2 or 3 limbs on either backend.
+const BigInteger one_limb(7);
+const BigInteger two_limbs(1234);
+const BigInteger three_limbs(1234567);
+
+// Calls and limbs recorded for op, with every call expected to fall in the histogram bucket of limbs_per_call.
+bool recorded(Operation op, uint64_t calls, uint64_t limbs_per_call) {
+    const bigint_stats::OperationStats& stats = bigint_stats::get(op);
+    size_t bucket = std::bit_width(limbs_per_call);
+    uint64_t in_buckets = 0;
+    for (const auto& count : stats.histogram) {
+        in_buckets += count;
+    }
+    bool same = stats.calls == calls && stats.limbs == calls * limbs_per_call && stats.histogram[bucket] == calls &&
+                in_buckets == calls;
+    if (!same) {
+        std::cout << bigint_stats::name(op) << ": calls " << stats.calls << ", limbs " << stats.limbs << '\n';
+    }
+    return same;
+}
+
+std::string dumped() {
+    std::ostringstream out;
+    bigint_stats::dump(out);
+    return out.str();
+}
+
+TestGroup all_tests[] = {
+    TestGroup("Instrumentation",
+        make_pretty_test("counts per operation", [](auto& test) {
+            bigint_stats::reset();
+            for (int i = 0; i < 5; ++i) {
+                BigInteger product = two_limbs;
+                product *= three_limbs;
+            }
+            test.check(recorded(Operation::Multiply, 5, 5));
+#ifndef BIGINTEGER_USE_GMP
+            test.check(bigint_stats::get(Operation::Multiply).estimated_allocations >= 10);
+#endif
+
+            for (int i = 0; i < 3; ++i) {
+                auto [div, mod] = three_limbs.div_mod(one_limb);
+                test.check(div == 176366 && mod == 5);
+            }
+            test.check(recorded(Operation::DivMod, 3, 4));
+
+            for (int i = 0; i < 2; ++i) {
+                test.check(gcd(two_limbs, three_limbs) == 1);
+            }
+            test.check(bigint_stats::get(Operation::Gcd).calls == 2);
+            test.check(bigint_stats::get(Operation::Gcd).limbs == 10);
+
+            for (int i = 0; i < 4; ++i) {
+                test.check(three_limbs.toString() == "1234567");
+            }
+            test.check(recorded(Operation::ToString, 4, 3));
+
+            std::istringstream in("1234567 -7");
+            BigInteger x;
+            in >> x;
+            test.check(x == three_limbs);
+            in >> x;
+            test.check(x == -one_limb);
+            test.check(bigint_stats::get(Operation::Read).calls == 2 && bigint_stats::get(Operation::Read).limbs == 4);
+
+            test.check(recorded(Operation::Reduce, 0, 0));
+            Rational r(6, -1234);
+            test.check(recorded(Operation::Reduce, 1, 3));
+            test.check(bigint_stats::get(Operation::Gcd).calls == 3);
+            test.check(r.numerator() == -3 && r.denominator() == 617);
+            test.check(bigint_stats::fft_fallbacks() == 0);
+        }),
+
+        make_pretty_test("dump and reset", [](auto& test) {
+            bigint_stats::reset();
+            test.check(dumped().empty());
+            for (int i = 0; i < 5; ++i) {
+                BigInteger product = two_limbs;
+                product *= three_limbs;
+            }
+            std::string text = dumped();
+            test.check(text.starts_with("operator*=: calls 5, limbs 25, estimated allocations "));
+            test.check(text.find("    limbs < 2^3: 5\n") != std::string::npos);
+            test.check(text.find("div_mod") == std::string::npos && text.find("gcd") == std::string::npos);
+
+            bigint_stats::reset();
+            test.check(recorded(Operation::Multiply, 0, 0) && dumped().empty());
+            for (size_t i = 0; i < bigint_stats::OPERATION_COUNT; ++i) {
+                const auto& stats = bigint_stats::get(static_cast<Operation>(i));
+                test.check(stats.estimated_allocations == 0 && stats.nanoseconds == 0);
+            }
+        })
+    )
+};
+
+
+int main() {
+    bool success = true;
+    for (auto& group : all_tests) {
+        success &= group.run();
+    }
+    return success ? 0 : 1;
+}
@@ -0,0 +1,127 @@
+#include "tiny_test.hpp"
+#include "biginteger.h"
+#include "random.hpp"
+
+using testing::make_pretty_test;
+using testing::TestGroup;
+
+
+BigInteger absolute(BigInteger x) {
+    return x < 0 ? -x : x;
+}
+
+// s * a + t * b == g, g is the nonnegative gcd and the cofactors stay within |b| / g and |a| / g.
+bool validCofactors(const BigInteger& a, const BigInteger& b) {
+    auto [g, s, t] = gcdext(a, b);
+    bool valid = s * a + t * b == g && g == gcd(a, b) && g >= 0;
+    if (g != 0) {
+        valid &= absolute(s) <= absolute(b) / g + 1 && absolute(t) <= absolute(a) / g + 1;
+    }
+    if (!valid) {
+        std::cout << "gcdext(" << a << ", " << b << ") = " << g << ", " << s << ", " << t << "\n";
+    }
+    return valid;
+}
+
+template <typename F>
+bool throwsDomainError(F function) {
+    try {
+        function();
+    } catch (const std::domain_error&) {
+        return true;
+    }
+    return false;
+}
+
+// Random values of either sign, many of them above the modulus, with the non-invertible ones replaced by 1.
+std::vector<BigInteger> invertibleValues(size_t count, const BigInteger& m) {
+    std::vector<BigInteger> values;
+    for (size_t i = 0; i < count; ++i) {
+        BigInteger value(randomNumber(m.toString().size() + 5));
+        values.push_back(gcd(value, m) == 1 ? value : BigInteger(1));
+    }
+    return values;
+}
+
+TestGroup all_tests[] = {
+    TestGroup("gcdext",
+        make_pretty_test("random operands", [](auto& test) {
+            for (int i = 0; i < 200; ++i) {
+                BigInteger factor(randomNumber(50, false));
+                BigInteger a = BigInteger(randomNumber(300)) * factor;
+                test.check(validCofactors(a, BigInteger(randomNumber(300)) * factor));
+            }
+        }),
+
+        make_pretty_test("zero and negative operands", [](auto& test) {
+            BigInteger a(randomDigits(100));
+            for (const BigInteger& x : {a, -a, BigInteger(0), BigInteger(1), BigInteger(-1), BigInteger(7)}) {
+                for (const BigInteger& y : {a, -a, BigInteger(0), BigInteger(1), BigInteger(-1), BigInteger(-7)}) {
+                    test.check(validCofactors(x, y));
+                }
+            }
+            auto [g, s, t] = gcdext(BigInteger(0), BigInteger(0));
+            test.check(g == 0 && s == 0 && t == 0);
+        })
+    ),
+
+    TestGroup("invmod",
+        make_pretty_test("inverses", [](auto& test) {
+            BigInteger m(randomDigits(200, false));
+            for (const BigInteger& a : invertibleValues(100, m)) {
+                BigInteger inverse = invmod(a, m);
+                test.check(inverse >= 0 && inverse < m && ((a * inverse) % m + m) % m == 1);
+            }
+            test.check(invmod(BigInteger(5), BigInteger(1)) == 0);
+        }),
+
+        make_pretty_test("errors", [](auto& test) {
+            test.check(throwsDomainError([] { invmod(BigInteger(6), BigInteger(9)); }));
+            test.check(throwsDomainError([] { invmod(BigInteger(0), BigInteger(9)); }));
+            test.check(throwsDomainError([] { invmod(BigInteger(-3), BigInteger(9)); }));
+            test.check(throwsDomainError([] { invmod(BigInteger(2), BigInteger(0)); }));
+            test.check(throwsDomainError([] { invmod(BigInteger(2), BigInteger(-7)); }));
+        })
+    ),
+
+    TestGroup("batch_invmod",
+        make_pretty_test("matches invmod", [](auto& test) {
+            BigInteger m(randomDigits(150, false));
+            std::vector<BigInteger> values = invertibleValues(50, m);
+            std::vector<BigInteger> inverses = batch_invmod(values, m);
+            test.check(inverses.size() == values.size());
+            for (size_t i = 0; i < values.size(); ++i) {
+                test.check(inverses[i] == invmod(values[i], m));
+            }
+        }),
+
+        make_pretty_test("thread counts agree", [](auto& test) {
+            BigInteger m(randomDigits(100, false));
+            for (size_t count : {size_t{1}, size_t{2}, size_t{5}, size_t{64}}) {
+                std::vector<BigInteger> values = invertibleValues(count, m);
+                std::vector<BigInteger> serial = batch_invmod(values, m, 1);
+                test.check(batch_invmod(values, m, 3) == serial);
+                test.check(batch_invmod(values, m, 0) == serial);
+            }
+            test.check(batch_invmod({}, m, 3).empty());
+        }),
+
+        make_pretty_test("errors", [](auto& test) {
+            BigInteger m(9);
+            std::vector<BigInteger> values = {BigInteger(2), BigInteger(4), BigInteger(6), BigInteger(8)};
+            for (unsigned threads : {1u, 3u, 0u}) {
+                test.check(throwsDomainError([&] { batch_invmod(values, m, threads); }));
+            }
+            test.check(throwsDomainError([&] { batch_invmod(values, BigInteger(0)); }));
+        })
+    )
+};
+
+
+int main() {
+    bool success = true;
+    for (auto& group : all_tests) {
+        success &= group.run();
+    }
+    return success ? 0 : 1;
+}
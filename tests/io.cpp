@@ -0,0 +1,250 @@
+#include "tiny_test.hpp"
+#include "biginteger.h"
+#include "random.hpp"
+
+#include <sstream>
+
+using testing::make_pretty_test;
+using testing::TestGroup;
+
+
+// Reads one BigInteger from text and reports the value, the stream state and the next unread character.
+struct Read {
+    BigInteger value;
+    bool fail;
+    bool eof;
+    int next;
+};
+
+Read readFrom(const std::string& text, std::ios_base::fmtflags basefield = std::ios_base::dec) {
+    std::istringstream in(text);
+    in.setf(basefield, std::ios_base::basefield);
+    Read result{BigInteger(-1), false, false, 0};
+    in >> result.value;
+    result.fail = in.fail();
+    result.eof = in.eof();
+    in.clear();
+    result.next = in.get();
+    return result;
+}
+
+TestGroup all_tests[] = {
+    TestGroup("operator>>",
+        make_pretty_test("empty and sign-only tokens fail", [](auto& test) {
+            for (const char* text : {"", "   ", "\n"}) {
+                Read read = readFrom(text);
+                test.check(read.fail && read.eof);
+            }
+            for (const char* text : {"-", "+", "  -"}) {
+                Read read = readFrom(text);
+                test.check(read.fail && read.eof);
+            }
+            for (const char* text : {"- 5", "+x", "-+5", "abc", "--1"}) {
+                Read read = readFrom(text);
+                test.check(read.fail && !read.eof);
+            }
+            Read hex = readFrom("0x", std::ios_base::hex);
+            test.check(hex.fail && hex.eof);
+        }),
+
+        make_pretty_test("stops at the first non-digit", [](auto& test) {
+            Read read = readFrom("123abc");
+            test.check(!read.fail && !read.eof && read.value == 123 && read.next == 'a');
+            read = readFrom("  -0042 17");
+            test.check(!read.fail && read.value == -42 && read.next == ' ');
+            read = readFrom("+7-8");
+            test.check(!read.fail && read.value == 7 && read.next == '-');
+            read = readFrom("99.5");
+            test.check(!read.fail && read.value == 99 && read.next == '.');
+            read = readFrom("12345678901234567890123");
+            test.check(!read.fail && read.eof && read.value == BigInteger("12345678901234567890123"));
+            read = readFrom("- 5");
+            test.check(read.next == ' ');
+        }),
+
+        make_pretty_test("consecutive reads keep the position", [](auto& test) {
+            std::string a = randomDigits(500);
+            std::string b = randomDigits(30);
+            std::istringstream in(a + "\n\t" + b + ",7 tail");
+            BigInteger x;
+            BigInteger y;
+            BigInteger z;
+            in >> x >> y;
+            test.check(x == BigInteger(a) && y == BigInteger(b) && in.peek() == ',');
+            in.ignore();
+            in >> z;
+            std::string rest;
+            in >> rest;
+            test.check(z == 7 && rest == "tail");
+            in >> z;
+            test.check(in.fail() && z == 7);
+        })
+    ),
+
+    TestGroup("to_chars and from_chars",
+        make_pretty_test("short buffers", [](auto& test) {
+            for (size_t digits : {size_t{1}, size_t{3}, size_t{4}, size_t{100}, size_t{2000}}) {
+                BigInteger x(randomDigits(digits));
+                for (int base : {10, 2, 16, 36}) {
+                    std::string expected = x.toString(base);
+                    std::string buffer(expected.size() + 5, '#');
+                    char* first = buffer.data();
+                    auto [ptr, ec] = to_chars(first, first + expected.size(), x, base);
+                    test.check(ec == std::errc() && std::string(first, ptr) == expected);
+                    for (size_t length : {size_t{0}, size_t{1}, expected.size() - 1}) {
+                        if (length >= expected.size()) {
+                            continue;
+                        }
+                        auto result = to_chars(first, first + length, x, base);
+                        test.check(result.ec == std::errc::value_too_large && result.ptr == first + length);
+                    }
+                }
+            }
+            char empty[1] = {'#'};
+            auto result = to_chars(empty, empty, BigInteger(-5));
+            test.check(result.ec == std::errc::value_too_large && result.ptr == empty && empty[0] == '#');
+        }),
+
+        make_pretty_test("invalid arguments", [](auto& test) {
+            char buffer[16];
+            for (int base : {-1, 0, 1, 37}) {
+                auto written = to_chars(buffer, buffer + sizeof(buffer), BigInteger(42), base);
+                test.check(written.ec == std::errc::invalid_argument);
+                std::string text = "42";
+                BigInteger x(7);
+                auto read = from_chars(text.data(), text.data() + text.size(), x, base);
+                test.check(read.ec == std::errc::invalid_argument && read.ptr == text.data() && x == 7);
+            }
+            for (const char* text : {"", "-", "+5", " 5", "x12", "-x", "--5"}) {
+                std::string s = text;
+                BigInteger x(7);
+                auto read = from_chars(s.data(), s.data() + s.size(), x);
+                test.check(read.ec == std::errc::invalid_argument && read.ptr == s.data() && x == 7);
+            }
+            std::string s = "9";
+            BigInteger x(7);
+            auto read = from_chars(s.data(), s.data() + s.size(), x, 8);
+            test.check(read.ec == std::errc::invalid_argument && read.ptr == s.data() && x == 7);
+        }),
+
+        make_pretty_test("partial parses", [](auto& test) {
+            struct Case {
+                std::string text;
+                int base;
+                BigInteger value;
+                size_t consumed;
+            };
+            std::vector<Case> cases = {
+                {"123abc", 10, BigInteger(123), 3},
+                {"-0017z", 10, BigInteger(-17), 5},
+                {"12 34", 10, BigInteger(12), 2},
+                {"fFg", 16, BigInteger(255), 2},
+                {"-101201", 2, BigInteger(-5), 4},
+                {"0x1f", 16, BigInteger(0), 1},
+                {"zz.", 36, BigInteger(1295), 2},
+            };
+            for (const Case& c : cases) {
+                BigInteger x;
+                auto [ptr, ec] = from_chars(c.text.data(), c.text.data() + c.text.size(), x, c.base);
+                test.check(ec == std::errc() && x == c.value && ptr == c.text.data() + c.consumed);
+            }
+            std::string digits = randomDigits(3000);
+            std::string text = digits + "e5";
+            BigInteger x;
+            auto [ptr, ec] = from_chars(text.data(), text.data() + text.size(), x);
+            test.check(ec == std::errc() && x == BigInteger(digits) && *ptr == 'e');
+        }),
+
+        make_pretty_test("decimal size hint", [](auto& test) {
+            for (const char* text : {"0", "9", "-9", "999", "-1000", "1000000", "-999999999999"}) {
+                BigInteger x(text);
+                test.check(x.decimal_size_hint() >= x.toString().size());
+            }
+            for (int i = 0; i < 200; ++i) {
+                BigInteger x(randomDigits(randomSize()));
+                test.check(x.decimal_size_hint() >= x.toString().size());
+            }
+        })
+    ),
+
+    TestGroup("Stream bases",
+        make_pretty_test("output flags", [](auto& test) {
+            const std::ios_base::fmtflags flag_sets[] = {
+                std::ios_base::hex,
+                std::ios_base::hex | std::ios_base::showbase,
+                std::ios_base::hex | std::ios_base::showbase | std::ios_base::uppercase,
+                std::ios_base::hex | std::ios_base::uppercase,
+                std::ios_base::oct,
+                std::ios_base::oct | std::ios_base::showbase,
+                std::ios_base::dec | std::ios_base::showbase | std::ios_base::uppercase,
+                std::ios_base::dec | std::ios_base::showpos,
+            };
+            for (long long value : {1LL, 7LL, 8LL, 255LL, 4096LL, 0xabcdefLL, 0x7fffffffffffffffLL}) {
+                for (auto flags : flag_sets) {
+                    std::ostringstream expected;
+                    std::ostringstream out;
+                    expected.flags(flags);
+                    out.flags(flags);
+                    expected << value;
+                    out << BigInteger(value);
+                    test.check(out.str() == expected.str());
+                }
+            }
+
+            std::ostringstream out;
+            out << std::hex << BigInteger(-255) << ' ' << std::showbase << BigInteger(-255) << ' ' << std::uppercase
+                << BigInteger(-255) << ' ' << std::oct << BigInteger(-8) << ' ' << BigInteger(0) << ' ' << std::dec
+                << std::showpos << BigInteger(12) << ' ' << BigInteger(-12);
+            test.check(out.str() == "-ff -0xff -0XFF -010 0 +12 -12");
+
+            BigInteger x(randomDigits(500, false));
+            std::ostringstream hex;
+            hex << std::hex << std::showbase << x << ' ' << -x;
+            test.check(hex.str() == "0x" + x.toString(16) + " -0x" + x.toString(16));
+        }),
+
+        make_pretty_test("input bases", [](auto& test) {
+            Read read = readFrom("ff", std::ios_base::hex);
+            test.check(!read.fail && read.value == 255);
+            read = readFrom("-0XFFg", std::ios_base::hex);
+            test.check(!read.fail && read.value == -255 && read.next == 'g');
+            read = readFrom("178", std::ios_base::oct);
+            test.check(!read.fail && read.value == 15 && read.next == '8');
+            read = readFrom("0x1f", std::ios_base::dec);
+            test.check(!read.fail && read.value == 0 && read.next == 'x');
+            read = readFrom("9", std::ios_base::oct);
+            test.check(read.fail && read.next == '9');
+
+            std::ios_base::fmtflags automatic{};
+            read = readFrom("0x1f", automatic);
+            test.check(!read.fail && read.value == 31);
+            read = readFrom("-017", automatic);
+            test.check(!read.fail && read.value == -15);
+            read = readFrom("42", automatic);
+            test.check(!read.fail && read.value == 42);
+            read = readFrom("0", automatic);
+            test.check(!read.fail && read.eof && read.value == 0);
+            read = readFrom("09", automatic);
+            test.check(!read.fail && read.value == 0 && read.next == '9');
+
+            BigInteger x(randomDigits(700));
+            for (auto [flags, base] : {std::pair{std::ios_base::hex, 16}, std::pair{std::ios_base::oct, 8}}) {
+                std::ostringstream out;
+                out.flags(flags | std::ios_base::showbase);
+                out << x;
+                test.check(readFrom(out.str(), flags).value == x);
+                test.check(readFrom(out.str(), automatic).value == x);
+                test.check(readFrom(x.toString(base), flags).value == x);
+            }
+        })
+    )
+};
+
+
+int main() {
+    bool success = true;
+    for (auto& group : all_tests) {
+        success &= group.run();
+    }
+    return success ? 0 : 1;
+}
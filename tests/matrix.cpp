@@ -0,0 +1,253 @@
+#include "tiny_test.hpp"
+#include "biginteger.h"
+#include "random.hpp"
+
+using testing::make_pretty_test;
+using testing::TestGroup;
+
+
+using IntMatrix = Matrix<BigInteger>;
+using RationalMatrix = Matrix<Rational>;
+
+IntMatrix randomMatrix(size_t rows, size_t cols, size_t digits) {
+    IntMatrix result(rows, cols);
+    for (size_t i = 0; i < rows; ++i) {
+        for (size_t j = 0; j < cols; ++j) {
+            result(i, j) = BigInteger(randomNumber(digits));
+        }
+    }
+    return result;
+}
+
+IntMatrix naiveProduct(const IntMatrix& a, const IntMatrix& b) {
+    IntMatrix c(a.rows(), b.cols());
+    for (size_t i = 0; i < a.rows(); ++i) {
+        for (size_t j = 0; j < b.cols(); ++j) {
+            for (size_t k = 0; k < a.cols(); ++k) {
+                c(i, j) += a(i, k) * b(k, j);
+            }
+        }
+    }
+    return c;
+}
+
+// Rows (1, x, x^2, ...) for x = 1..n; the determinant is the product of the differences of the x.
+IntMatrix vandermonde(size_t n) {
+    IntMatrix result(n, n);
+    for (size_t i = 0; i < n; ++i) {
+        BigInteger power = 1;
+        for (size_t j = 0; j < n; ++j) {
+            result(i, j) = power;
+            power *= static_cast<long long>(i + 1);
+        }
+    }
+    return result;
+}
+
+BigInteger vandermondeDeterminant(size_t n) {
+    BigInteger det = 1;
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = i + 1; j < n; ++j) {
+            det *= static_cast<long long>(j - i);
+        }
+    }
+    return det;
+}
+
+Rational fraction(long long numerator, long long denominator) {
+    return Rational(BigInteger(numerator), BigInteger(denominator));
+}
+
+// Multiplying by 13 throws, so a worker of the threaded product fails partway through its rows.
+struct Unlucky {
+    long long value = 0;
+
+    Unlucky() = default;
+    Unlucky(long long x) : value(x) {}
+
+    bool operator==(const Unlucky&) const = default;
+    Unlucky& operator+=(const Unlucky& x) {
+        value += x.value;
+        return *this;
+    }
+    friend Unlucky operator*(const Unlucky& a, const Unlucky& b) {
+        if (a.value == 13 || b.value == 13) {
+            throw std::runtime_error("unlucky");
+        }
+        return Unlucky(a.value * b.value);
+    }
+};
+
+template <typename Exception, typename F>
+bool throws(F function) {
+    try {
+        function();
+    } catch (const Exception&) {
+        return true;
+    }
+    return false;
+}
+
+const unsigned thread_counts[] = {1, 2, 3, 0};
+
+TestGroup all_tests[] = {
+    TestGroup("Matrix",
+        make_pretty_test("known products", [](auto& test) {
+            IntMatrix a{{BigInteger(1), BigInteger(2)}, {BigInteger(3), BigInteger(4)}};
+            IntMatrix b{{BigInteger(5), BigInteger(6)}, {BigInteger(7), BigInteger(8)}};
+            test.check(a * b == IntMatrix{{BigInteger(19), BigInteger(22)}, {BigInteger(43), BigInteger(50)}});
+            test.check(a * IntMatrix::identity(2) == a && IntMatrix::identity(2) * a == a);
+            test.check(a + b - b == a);
+
+            IntMatrix row{{BigInteger(1), BigInteger(-2), BigInteger(3)}};
+            IntMatrix column{{BigInteger(4)}, {BigInteger(5)}, {BigInteger(-6)}};
+            test.check(row * column == IntMatrix{{BigInteger(-24)}});
+            IntMatrix outer = column * row;
+            test.check(outer.rows() == 3 && outer.cols() == 3 && outer(2, 1) == 12);
+
+            test.check(throws<std::invalid_argument>([&] { (void)(row * row); }));
+            test.check(throws<std::invalid_argument>([&] { (void)(a + row); }));
+            test.check(throws<std::invalid_argument>([] {
+                IntMatrix ragged{{BigInteger(1)}, {BigInteger(2), BigInteger(3)}};
+            }));
+        }),
+
+        make_pretty_test("threaded multiply", [](auto& test) {
+            for (auto [rows, inner, cols] : {std::array<size_t, 3>{1, 1, 1}, {70, 50, 40}, {100, 3, 65}}) {
+                IntMatrix a = randomMatrix(rows, inner, 30);
+                IntMatrix b = randomMatrix(inner, cols, 30);
+                IntMatrix expected = naiveProduct(a, b);
+                for (unsigned threads : thread_counts) {
+                    test.check(multiply(a, b, threads) == expected);
+                }
+            }
+        }),
+
+        make_pretty_test("worker exceptions", [](auto& test) {
+            Matrix<Unlucky> a(200, 4);
+            Matrix<Unlucky> b(4, 4);
+            for (size_t i = 0; i < 200; ++i) {
+                for (size_t j = 0; j < 4; ++j) {
+                    a(i, j) = Unlucky(static_cast<long long>(i + j + 1) % 12 + 1);
+                }
+            }
+            for (size_t i = 0; i < 4; ++i) {
+                b(i, i) = Unlucky(1);
+            }
+            for (unsigned threads : thread_counts) {
+                test.check(multiply(a, b, threads) == a);
+            }
+            a(150, 2) = Unlucky(13);
+            for (unsigned threads : thread_counts) {
+                test.check(throws<std::runtime_error>([&] { multiply(a, b, threads); }));
+            }
+        })
+    ),
+
+    TestGroup("determinant",
+        make_pretty_test("known values", [](auto& test) {
+            IntMatrix tridiagonal{{BigInteger(2), BigInteger(-1), BigInteger(0)},
+                                  {BigInteger(-1), BigInteger(2), BigInteger(-1)},
+                                  {BigInteger(0), BigInteger(-1), BigInteger(2)}};
+            IntMatrix swapped{{BigInteger(0), BigInteger(1)}, {BigInteger(1), BigInteger(0)}};
+            for (unsigned threads : thread_counts) {
+                test.check(determinant(tridiagonal, threads) == 4);
+                test.check(determinant(swapped, threads) == -1);
+                test.check(determinant(IntMatrix{{BigInteger(-7)}}, threads) == -7);
+                test.check(determinant(IntMatrix(), threads) == 1);
+                for (size_t n : {size_t{5}, size_t{8}, size_t{20}}) {
+                    test.check(determinant(vandermonde(n), threads) == vandermondeDeterminant(n));
+                    test.check(determinant_modular(vandermonde(n), threads) == vandermondeDeterminant(n));
+                }
+            }
+            RationalMatrix halves{{fraction(1, 2), fraction(1, 3)}, {fraction(1, 4), fraction(1, 5)}};
+            test.check(determinant(halves) == fraction(1, 60));
+        }),
+
+        // Entries of 200 digits keep matrices below 9 rows on threaded Bareiss elimination.
+        make_pretty_test("Bareiss and residues agree", [](auto& test) {
+            for (size_t n : {size_t{1}, size_t{2}, size_t{6}, size_t{8}}) {
+                IntMatrix m = randomMatrix(n, n, 200);
+                BigInteger expected = determinant_modular(m, 1);
+                for (unsigned threads : thread_counts) {
+                    test.check(determinant(m, threads) == expected);
+                    test.check(determinant_modular(m, threads) == expected);
+                }
+            }
+        }),
+
+        make_pretty_test("singular and non-square", [](auto& test) {
+            for (size_t n : {size_t{3}, size_t{10}}) {
+                IntMatrix m = randomMatrix(n, n, 20);
+                for (size_t j = 0; j < n; ++j) {
+                    m(n - 1, j) = m(0, j) * 3 - m(1, j);
+                }
+                for (unsigned threads : thread_counts) {
+                    test.check(determinant(m, threads) == 0);
+                    test.check(determinant_modular(m, threads) == 0);
+                }
+            }
+            test.check(determinant(IntMatrix(3, 3)) == 0);
+            test.check(throws<std::invalid_argument>([] { determinant(IntMatrix(2, 3)); }));
+            test.check(throws<std::invalid_argument>([] { determinant_modular(IntMatrix(3, 2)); }));
+        })
+    ),
+
+    TestGroup("solve",
+        make_pretty_test("known solutions", [](auto& test) {
+            IntMatrix a{{BigInteger(2), BigInteger(1)}, {BigInteger(1), BigInteger(3)}};
+            std::vector<Rational> expected = {fraction(2, 5), fraction(1, 5)};
+            test.check(solve(a, {BigInteger(1), BigInteger(1)}) == expected);
+            test.check(solve(IntMatrix{{BigInteger(3)}}, {BigInteger(6)}) == std::vector<Rational>{fraction(2, 1)});
+            test.check(solve(IntMatrix(), {}).empty());
+
+            RationalMatrix r{{fraction(1, 2), fraction(0, 1)}, {fraction(0, 1), fraction(-2, 3)}};
+            std::vector<Rational> r_expected = {fraction(2, 1), fraction(-3, 2)};
+            test.check(solve(r, {fraction(1, 1), fraction(1, 1)}) == r_expected);
+        }),
+
+        make_pretty_test("recovers planted solutions", [](auto& test) {
+            for (size_t n : {size_t{2}, size_t{5}, size_t{12}}) {
+                IntMatrix a = vandermonde(n);
+                IntMatrix x = randomMatrix(n, 1, 30);
+                IntMatrix b = a * x;
+                std::vector<BigInteger> rhs(n);
+                for (size_t i = 0; i < n; ++i) {
+                    rhs[i] = b(i, 0);
+                }
+                for (unsigned threads : thread_counts) {
+                    std::vector<Rational> solution = solve(a, rhs, threads);
+                    bool same = solution.size() == n;
+                    for (size_t i = 0; same && i < n; ++i) {
+                        same = solution[i] == Rational(x(i, 0));
+                    }
+                    test.check(same);
+                }
+            }
+        }),
+
+        make_pretty_test("singular and non-square", [](auto& test) {
+            for (size_t n : {size_t{3}, size_t{10}}) {
+                IntMatrix a = randomMatrix(n, n, 20);
+                for (size_t j = 0; j < n; ++j) {
+                    a(n - 1, j) = a(0, j) + a(1, j);
+                }
+                std::vector<BigInteger> rhs(n, BigInteger(1));
+                for (unsigned threads : thread_counts) {
+                    test.check(throws<std::domain_error>([&] { solve(a, rhs, threads); }));
+                }
+            }
+            test.check(throws<std::invalid_argument>([] { solve(IntMatrix(2, 3), {BigInteger(1), BigInteger(2)}); }));
+            test.check(throws<std::invalid_argument>([] { solve(IntMatrix::identity(2), {BigInteger(1)}); }));
+        })
+    )
+};
+
+
+int main() {
+    bool success = true;
+    for (auto& group : all_tests) {
+        success &= group.run();
+    }
+    return success ? 0 : 1;
+}
@@ -0,0 +1,116 @@
+#include "tiny_test.hpp"
+#include "biginteger.h"
+#include "random.hpp"
+
+using testing::make_pretty_test;
+using testing::TestGroup;
+
+
+// reduce() against mod_small prime by prime, and reconstruct() back to x.
+bool roundTrips(const ModularBasis& basis, const BigInteger& x, unsigned threads) {
+    std::vector<uint64_t> residues = basis.reduce(x, threads);
+    bool same = residues.size() == basis.size();
+    for (size_t i = 0; same && i < residues.size(); ++i) {
+        auto p = static_cast<long long>(basis.prime(i));
+        same = static_cast<long long>(residues[i]) == x.mod_small(p);
+    }
+    same = same && basis.reconstruct(residues, threads) == x;
+    if (!same) {
+        std::cout << "round trip of " << x << " over " << basis.size() << " primes\n";
+    }
+    return same;
+}
+
+template <typename Exception, typename F>
+bool throws(F function) {
+    try {
+        function();
+    } catch (const Exception&) {
+        return true;
+    }
+    return false;
+}
+
+const unsigned thread_counts[] = {1, 3};
+
+TestGroup all_tests[] = {
+    TestGroup("ModularBasis",
+        make_pretty_test("round trips", [](auto& test) {
+            for (size_t bits : {size_t{10}, size_t{1000}, size_t{5000}}) {
+                ModularBasis basis(bits);
+                size_t digits = bits * 3 / 10;
+                for (unsigned threads : thread_counts) {
+                    test.check(roundTrips(basis, BigInteger(0), threads));
+                    test.check(roundTrips(basis, BigInteger(1), threads));
+                    test.check(roundTrips(basis, BigInteger(-1), threads));
+                    for (int i = 0; i < 10; ++i) {
+                        BigInteger x(randomNumber(digits));
+                        test.check(roundTrips(basis, x, threads));
+                        test.check(roundTrips(basis, -x, threads));
+                    }
+                }
+            }
+        }),
+
+        make_pretty_test("modulus bound", [](auto& test) {
+            for (size_t bits : {size_t{10}, size_t{1000}}) {
+                ModularBasis basis(bits, 2);
+                BigInteger m = basis.modulus();
+                BigInteger half = (m - 1) / 2;
+                test.check(m > 0 && m % 2 == 1);
+                for (unsigned threads : thread_counts) {
+                    test.check(roundTrips(basis, half, threads));
+                    test.check(roundTrips(basis, -half, threads));
+                    test.check(roundTrips(basis, half - 1, threads));
+                    test.check(basis.reconstruct(basis.reduce(half + 1, threads), threads) == -half);
+                    test.check(basis.reconstruct(basis.reduce(-half - 1, threads), threads) == half);
+                    test.check(basis.reconstruct(basis.reduce(m, threads), threads) == 0);
+                    test.check(basis.reconstruct(basis.reduce(-3 * m + 5, threads), threads) == 5);
+                }
+            }
+            ModularBasis basis(100);
+            test.check(throws<std::invalid_argument>([&] { basis.reconstruct({1, 2}); }));
+        })
+    ),
+
+    TestGroup("MultiModular",
+        make_pretty_test("products and sums", [](auto& test) {
+            auto basis = std::make_shared<const ModularBasis>(2500, 2);
+            for (int i = 0; i < 20; ++i) {
+                BigInteger a(randomNumber(350));
+                BigInteger b(randomNumber(350));
+                BigInteger c(randomNumber(700));
+                MultiModular x(basis, a);
+                MultiModular y(basis, b, 3);
+                MultiModular z(basis, c);
+                test.check((x * y).toBigInteger() == a * b);
+                test.check(BigInteger(x * y - z) == a * b - c);
+                test.check((x * y + z).toBigInteger(3) == a * b + c);
+                test.check(BigInteger(-x * y) == -(a * b));
+                test.check(x * y == MultiModular(basis, a * b));
+            }
+            MultiModular small(basis, -12345);
+            test.check(small.toBigInteger() == -12345 && (small * small).toBigInteger() == 12345LL * 12345);
+            test.check(MultiModular(basis).toBigInteger() == 0);
+        }),
+
+        make_pretty_test("different bases", [](auto& test) {
+            auto first = std::make_shared<const ModularBasis>(100);
+            auto second = std::make_shared<const ModularBasis>(100);
+            MultiModular x(first, 5);
+            MultiModular y(second, 5);
+            test.check(x != y);
+            test.check(throws<std::invalid_argument>([&] { x += y; }));
+            test.check(throws<std::invalid_argument>([&] { x *= y; }));
+        })
+    )
+};
+
+
+int main() {
+    bool success = true;
+    for (auto& group : all_tests) {
+        success &= group.run();
+    }
+    return success ? 0 : 1;
+}
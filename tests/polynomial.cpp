@@ -0,0 +1,80 @@
+#include "tiny_test.hpp"
+#include "biginteger.h"
+#include "random.hpp"
+
+using testing::make_pretty_test;
+using testing::TestGroup;
+
+
+using IntPolynomial = Polynomial<BigInteger>;
+using RationalPolynomial = Polynomial<Rational>;
+
+IntPolynomial randomPolynomial(size_t terms, size_t digits) {
+    std::vector<BigInteger> coefficients;
+    for (size_t i = 0; i < terms; ++i) {
+        coefficients.emplace_back(randomNumber(digits));
+    }
+    coefficients.back() = BigInteger(randomDigits(digits));
+    return IntPolynomial(std::move(coefficients));
+}
+
+template <typename F>
+bool throwsDomainError(F function) {
+    try {
+        function();
+    } catch (const std::domain_error&) {
+        return true;
+    }
+    return false;
+}
+
+TestGroup all_tests[] = {
+    TestGroup("Polynomial division",
+        make_pretty_test("monic and unit divisors", [](auto& test) {
+            for (size_t terms : {size_t{3}, size_t{40}}) {
+                IntPolynomial g = randomPolynomial(terms, 20);
+                IntPolynomial monic = g - IntPolynomial::monomial(g.leading() - 1, g.coefficients().size() - 1);
+                for (const IntPolynomial& divisor : {monic, -monic}) {
+                    IntPolynomial f = randomPolynomial(2 * terms + 5, 20);
+                    auto [div, mod] = f.div_mod(divisor);
+                    test.check(div * divisor + mod == f && mod.degree() < divisor.degree());
+                }
+            }
+        }),
+
+        make_pretty_test("exact non-monic quotients", [](auto& test) {
+            for (size_t terms : {size_t{2}, size_t{5}, size_t{40}}) {
+                IntPolynomial g = randomPolynomial(terms, 10);
+                IntPolynomial q = randomPolynomial(terms + 3, 10);
+                IntPolynomial r = randomPolynomial(terms - 1, 10);
+                auto [div, mod] = (q * g).div_mod(g);
+                test.check(div == q && !mod);
+                test.check((q * g + r) / g == q && (q * g + r) % g == r);
+            }
+        }),
+
+        make_pretty_test("inexact non-monic quotient throws", [](auto& test) {
+            IntPolynomial f{BigInteger(1), BigInteger(0), BigInteger(1)};
+            IntPolynomial g{BigInteger(1), BigInteger(2)};
+            test.check(throwsDomainError([&] { f.div_mod(g); }));
+            test.check(throwsDomainError([&] { (void)(f / g); }));
+            test.check(throwsDomainError([&] { (void)(f % g); }));
+            test.check(throwsDomainError([&] { f.div_mod(IntPolynomial()); }));
+
+            RationalPolynomial rf{Rational(BigInteger(1)), Rational(BigInteger(0)), Rational(BigInteger(1))};
+            RationalPolynomial rg{Rational(BigInteger(1)), Rational(BigInteger(2))};
+            auto [div, mod] = rf.div_mod(rg);
+            test.check(div * rg + mod == rf && mod.degree() == 0);
+            test.check(div.leading() == Rational(BigInteger(1), BigInteger(2)));
+        })
+    )
+};
+
+
+int main() {
+    bool success = true;
+    for (auto& group : all_tests) {
+        success &= group.run();
+    }
+    return success ? 0 : 1;
+}
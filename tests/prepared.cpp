@@ -0,0 +1,94 @@
+#include "tiny_test.hpp"
+#include "biginteger.h"
+#include "random.hpp"
+
+#include <thread>
+
+using testing::make_pretty_test;
+using testing::TestGroup;
+
+
+// Operand lengths in limbs around the schoolbook cutoff of 32 limbs, balanced and past the 8:1 chunking ratio.
+const size_t limb_counts[] = {1, 5, 32, 33, 40, 100, 300, 1000, 3000};
+
+BigInteger randomLimbs(size_t limbs) {
+    return BigInteger(randomDigits(3 * limbs));
+}
+
+bool matchesProduct(const PreparedMultiplier& m, const BigInteger& x) {
+    BigInteger expected = x * m.value();
+    bool same = x * m == expected && m * x == expected;
+    if (!same) {
+        std::cout << "product of " << x.toString().size() << " by " << m.value().toString().size() << " digits\n";
+    }
+    return same;
+}
+
+TestGroup all_tests[] = {
+    TestGroup("PreparedMultiplier",
+        make_pretty_test("schoolbook and transform sizes", [](auto& test) {
+            for (size_t factor_limbs : limb_counts) {
+                PreparedMultiplier m(randomLimbs(factor_limbs));
+                for (size_t limbs : limb_counts) {
+                    test.check(matchesProduct(m, randomLimbs(limbs)));
+                    test.check(matchesProduct(m, randomLimbs(limbs)));
+                }
+            }
+        }),
+
+        make_pretty_test("signs, zero and one", [](auto& test) {
+            BigInteger a = randomLimbs(200);
+            for (const BigInteger& factor : {a, -a, BigInteger(0), BigInteger(1), BigInteger(-1)}) {
+                PreparedMultiplier m(factor);
+                for (const BigInteger& x : {randomLimbs(150), -randomLimbs(150), randomLimbs(2000), BigInteger(0)}) {
+                    test.check(matchesProduct(m, x) && matchesProduct(m, -x));
+                }
+            }
+            PreparedMultiplier m(a);
+            test.check((randomLimbs(100) * 0) * m == 0 && (m * BigInteger(0)).toString() == "0");
+        }),
+
+        make_pretty_test("all nines", [](auto& test) {
+            // The largest limbs give the largest transform rounding error for each length.
+            for (size_t digits : {size_t{300}, size_t{3000}, size_t{30000}}) {
+                BigInteger nines(std::string(digits, '9'));
+                PreparedMultiplier m(nines);
+                test.check(matchesProduct(m, nines) && matchesProduct(m, BigInteger(std::string(digits * 9, '9'))));
+            }
+        }),
+
+        make_pretty_test("copies share the cache across threads", [](auto& test) {
+            PreparedMultiplier m(randomLimbs(400));
+            std::vector<BigInteger> operands;
+            for (size_t limbs : {size_t{300}, size_t{500}, size_t{4000}}) {
+                for (int i = 0; i < 4; ++i) {
+                    operands.push_back(randomLimbs(limbs));
+                }
+            }
+            std::vector<BigInteger> products(operands.size());
+            std::vector<std::thread> threads;
+            for (size_t t = 0; t < 4; ++t) {
+                threads.emplace_back([copy = m, &operands, &products, t] {
+                    for (size_t i = t; i < operands.size(); i += 4) {
+                        products[i] = operands[i] * copy;
+                    }
+                });
+            }
+            for (auto& thread : threads) {
+                thread.join();
+            }
+            for (size_t i = 0; i < operands.size(); ++i) {
+                test.check(products[i] == operands[i] * m.value() && products[i] == m * operands[i]);
+            }
+        })
+    )
+};
+
+
+int main() {
+    bool success = true;
+    for (auto& group : all_tests) {
+        success &= group.run();
+    }
+    return success ? 0 : 1;
+}
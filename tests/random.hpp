@@ -0,0 +1,25 @@
+#pragma once
+
+#include <random>
+#include <string>
+
+// Random operands shared by the test targets; the fixed seed keeps failures reproducible.
+inline std::mt19937_64 generator(50);
+
+inline std::string randomDigits(size_t length, bool allow_negative = true) {
+    std::string s = allow_negative && generator() % 2 ? "-" : "";
+    s += static_cast<char>('1' + generator() % 9);
+    while (--length) {
+        s += static_cast<char>('0' + generator() % 10);
+    }
+    return s;
+}
+
+inline std::string randomNumber(size_t max_digits, bool allow_negative = true) {
+    return randomDigits(1 + generator() % max_digits, allow_negative);
+}
+
+inline size_t randomSize() {
+    const size_t sizes[] = {20, 200, 2000, 8000};
+    return sizes[generator() % std::size(sizes)];
+}
@@ -0,0 +1,233 @@
+#include "tiny_test.hpp"
+#include "biginteger.h"
+#include "random.hpp"
+
+using testing::make_pretty_test;
+using testing::TestGroup;
+
+
+// operator<=> against the sign of the exact cross-product difference.
+bool ordersLikeCrossProducts(const Rational& a, const Rational& b) {
+    auto expected = a.numerator() * b.denominator() <=> b.numerator() * a.denominator();
+    bool same = (a <=> b) == expected && (b <=> a) == (0 <=> expected) && (a == b) == (expected == 0);
+    if (!same) {
+        std::cout << "comparison of " << a.numerator() << '/' << a.denominator() << " and " << b.numerator() << '/'
+                  << b.denominator() << '\n';
+    }
+    return same;
+}
+
+// p/q and (p * k + e)/(q * k): their leading limbs agree and they differ by e/(q * k), far past the estimate.
+std::pair<Rational, Rational> nearlyEqual(size_t digits, size_t scale_digits, long long e) {
+    BigInteger p(randomDigits(digits));
+    BigInteger q(randomDigits(digits, false));
+    BigInteger k(randomDigits(scale_digits, false));
+    return {Rational(p, q), Rational(p * k + e, q * k)};
+}
+
+using Terms = std::vector<BigInteger>;
+
+Terms terms(const BigInteger& p, const BigInteger& q) {
+    Terms result;
+    ContinuedFraction expansion(p, q);
+    for (const BigInteger& term : expansion) {
+        result.push_back(term);
+    }
+    return result;
+}
+
+// Folds [a0; a1, ..., an] back into a fraction.
+Rational evaluate(const Terms& expansion) {
+    Rational value(expansion.back());
+    for (size_t i = expansion.size() - 1; i-- > 0;) {
+        value = Rational(expansion[i]) + Rational(1) / value;
+    }
+    return value;
+}
+
+BigInteger powerOfTwo(size_t exponent) {
+    return BigInteger("1" + std::string(exponent, '0'), 2);
+}
+
+Rational distance(const Rational& a, const Rational& b) {
+    Rational d = a - b;
+    return d < 0 ? -d : d;
+}
+
+template <typename Exception, typename F>
+bool throws(F function) {
+    try {
+        function();
+    } catch (const Exception&) {
+        return true;
+    }
+    return false;
+}
+
+TestGroup all_tests[] = {
+    TestGroup("Rational comparison",
+        make_pretty_test("differences past the estimate", [](auto& test) {
+            for (size_t digits : {size_t{1}, size_t{5}, size_t{30}, size_t{300}}) {
+                for (size_t scale_digits : {size_t{10}, size_t{40}, size_t{500}}) {
+                    for (long long e : {-1LL, 0LL, 1LL}) {
+                        auto [a, b] = nearlyEqual(digits, scale_digits, e);
+                        test.check(ordersLikeCrossProducts(a, b));
+                        test.check(ordersLikeCrossProducts(-a, -b));
+                        test.check((a <=> b) == (-e <=> 0));
+                    }
+                }
+            }
+        }),
+
+        make_pretty_test("integers past the estimate", [](auto& test) {
+            BigInteger big("1" + std::string(100, '0'));
+            test.check(Rational(big + 1, big) > 1 && Rational(big - 1, big) < 1);
+            test.check(Rational(big + 1, big) > BigInteger(1) && Rational(big - 1, big) < BigInteger(1));
+            test.check(Rational(-big - 1, big) < -1 && Rational(-big + 1, big) > BigInteger(-1));
+            test.check(Rational(big * big + 1, big) > big && Rational(big * big - 1, big) < big);
+
+            for (long long b : {999999999LL, 1000000000LL, 123456789012345LL, std::numeric_limits<long long>::max()}) {
+                BigInteger value(b);
+                test.check(Rational(value * big + 1, big) > b && Rational(value * big - 1, big) < b);
+                test.check(Rational(-value * big + 1, big) > -b && Rational(-value * big - 1, big) < -b);
+                test.check(Rational(value * big, big) == b && (Rational(value * big, big) <=> b) == 0);
+            }
+            long long min = std::numeric_limits<long long>::min();
+            test.check(BigInteger(min).toString() == "-9223372036854775808");
+            test.check(Rational(BigInteger(min) * big - 1, big) < min);
+            test.check(Rational(BigInteger(min) * big + 1, big) > min);
+        }),
+
+        make_pretty_test("random operands", [](auto& test) {
+            for (int i = 0; i < 300; ++i) {
+                Rational a(BigInteger(randomNumber(40)), BigInteger(randomNumber(40, false)));
+                Rational b(BigInteger(randomNumber(40)), BigInteger(randomNumber(40, false)));
+                test.check(ordersLikeCrossProducts(a, b));
+                test.check(ordersLikeCrossProducts(a, a * 1) && ordersLikeCrossProducts(a, Rational(0)));
+            }
+            test.check(Rational(2, 4) == Rational(1, 2) && Rational(-1, 3) < Rational(0) && Rational(0) < 1);
+        })
+    ),
+
+    TestGroup("Continued fractions",
+        make_pretty_test("known expansions", [](auto& test) {
+            test.check(terms(355, 113) == Terms{3, 7, 16});
+            test.check(terms(-355, 113) == Terms{-4, 1, 6, 16} && terms(355, -113) == Terms{-4, 1, 6, 16});
+            test.check(terms(710, 226) == Terms{3, 7, 16});
+            test.check(terms(42, 1) == Terms{42} && terms(0, 7) == Terms{0} && terms(-1, 2) == Terms{-1, 2});
+            test.check(terms(7, 9) == Terms{0, 1, 3, 2});
+
+            BigInteger f0 = 1;
+            BigInteger f1 = 1;
+            for (int i = 0; i < 2000; ++i) {
+                f0 = std::exchange(f1, f0 + f1);
+            }
+            Terms golden = terms(f1, f0);
+            test.check(golden.size() == 2000 && golden.back() == 2);
+            test.check(std::all_of(golden.begin(), golden.end() - 1, [](const BigInteger& t) { return t == 1; }));
+        }),
+
+        make_pretty_test("terms rebuild the value", [](auto& test) {
+            for (int i = 0; i < 50; ++i) {
+                BigInteger p(randomNumber(400));
+                BigInteger q(randomNumber(400, false));
+                Terms expansion = terms(p, q);
+                test.check(evaluate(expansion) == Rational(p, q));
+                auto positive = [](const BigInteger& t) { return t > 0; };
+                test.check(std::all_of(expansion.begin() + 1, expansion.end(), positive));
+                test.check(expansion.size() == 1 || expansion.back() > 1);
+
+                ContinuedFraction exhausted(p, q);
+                for (size_t j = 0; j < expansion.size(); ++j) {
+                    exhausted.next();
+                }
+                test.check(exhausted.done() && exhausted.remainder() == gcd(p, q));
+                test.check(terms(p * 3, q * 3) == expansion && terms(-p, -q) == expansion);
+                test.check(throws<std::out_of_range>([&] { exhausted.next(); }));
+            }
+            test.check(throws<std::domain_error>([] { ContinuedFraction(BigInteger(1), BigInteger(0)); }));
+        })
+    ),
+
+    TestGroup("from_double",
+        make_pretty_test("exact binary values", [](auto& test) {
+            test.check(Rational::from_double(0.5) == Rational(1, 2));
+            test.check(Rational::from_double(-2.75) == Rational(-11, 4));
+            test.check(Rational::from_double(0.0) == 0 && Rational::from_double(-0.0) == 0);
+            test.check(Rational::from_double(3.0) == 3 && Rational::from_double(-1.0) == -1);
+            test.check(Rational::from_double(0.1) == Rational(BigInteger("3602879701896397"),
+                                                              BigInteger("36028797018963968")));
+            test.check(Rational::from_double(-0.1) == -Rational::from_double(0.1));
+
+            test.check(Rational::from_double(std::ldexp(1.0, 1000)) == powerOfTwo(1000));
+            test.check(Rational::from_double(std::ldexp(-3.0, 600)) == -3 * powerOfTwo(600));
+            test.check(Rational::from_double(std::ldexp(-5.0, -1000)) == Rational(BigInteger(-5), powerOfTwo(1000)));
+            Rational smallest = Rational::from_double(std::numeric_limits<double>::denorm_min());
+            test.check(smallest == Rational(BigInteger(1), powerOfTwo(1074)));
+            Rational largest = Rational::from_double(std::numeric_limits<double>::max());
+            test.check(largest == (powerOfTwo(53) - 1) * powerOfTwo(971));
+
+            for (double value : {0.5, -2.75, 0.1, 1.0 / 3, 6.02214076e23, 1e300, -123.456}) {
+                Rational r = Rational::from_double(value);
+                test.check(static_cast<double>(r) == value);
+                test.check(r.denominator() == powerOfTwo(r.denominator().toString(2).size() - 1));
+            }
+        }),
+
+        make_pretty_test("non-finite values", [](auto& test) {
+            test.check(throws<std::invalid_argument>([] { Rational::from_double(std::nan("")); }));
+            test.check(throws<std::invalid_argument>([] {
+                Rational::from_double(std::numeric_limits<double>::infinity());
+            }));
+            test.check(throws<std::invalid_argument>([] {
+                Rational::from_double(-std::numeric_limits<double>::infinity());
+            }));
+        })
+    ),
+
+    TestGroup("limit_denominator",
+        make_pretty_test("approximations of pi", [](auto& test) {
+            Rational pi = Rational::from_double(3.141592653589793);
+            std::pair<long long, Rational> expected[] = {
+                {1, Rational(3)}, {10, Rational(22, 7)}, {100, Rational(311, 99)}, {112, Rational(333, 106)},
+                {113, Rational(355, 113)}, {1000, Rational(355, 113)}, {30000, Rational(94053, 29938)},
+            };
+            for (const auto& [bound, approximation] : expected) {
+                test.check(pi.limit_denominator(bound) == approximation);
+                test.check((-pi).limit_denominator(bound) == -approximation);
+            }
+            test.check(Rational(355, 113).limit_denominator(113) == Rational(355, 113));
+            test.check(Rational(7, 10).limit_denominator(2) == Rational(1, 2));
+            test.check(Rational(-1, 3).limit_denominator(2) == Rational(-1, 2));
+            test.check(throws<std::invalid_argument>([&] { pi.limit_denominator(0); }));
+        }),
+
+        make_pretty_test("closest against every denominator", [](auto& test) {
+            for (int i = 0; i < 100; ++i) {
+                Rational value(BigInteger(randomNumber(6)), BigInteger(randomNumber(5, false)));
+                long long bound = 1 + static_cast<long long>(generator() % 40);
+                Rational result = value.limit_denominator(bound);
+                Rational best = distance(result, value);
+                bool closest = result.denominator() <= bound;
+                for (long long q = 1; q <= bound; ++q) {
+                    // The floor and ceiling of value * q are the only numerators worth trying over q.
+                    BigInteger scaled = value.numerator() * q;
+                    BigInteger p = scaled / value.denominator() - (scaled < 0 ? 1 : 0);
+                    for (BigInteger candidate : {p, p + 1}) {
+                        closest = closest && distance(Rational(candidate, BigInteger(q)), value) >= best;
+                    }
+                }
+                test.check(closest);
+            }
+        })
+    )
+};
+
+
+int main() {
+    bool success = true;
+    for (auto& group : all_tests) {
+        success &= group.run();
+    }
+    return success ? 0 : 1;
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <string>
+#include <gmp.h>
+#include "random.hpp"
+
+// GMP value used as the reference in the cross-checks.
+class Reference {
+public:
+    Reference() {
+        mpz_init(value);
+    }
+    explicit Reference(const std::string& s) : Reference() {
+        mpz_set_str(value, s.c_str(), 10);
+    }
+    Reference(const Reference&) = delete;
+    Reference& operator=(const Reference&) = delete;
+    ~Reference() {
+        mpz_clear(value);
+    }
+
+    std::string toString(int base = 10) const {
+        std::string s(mpz_sizeinbase(value, base) + 2, '\0');
+        mpz_get_str(s.data(), base, value);
+        s.resize(s.find('\0'));
+        return s;
+    }
+
+    mpz_t value;
+};
@@ -0,0 +1,122 @@
+#include "tiny_test.hpp"
+#include "biginteger.h"
+#include "random.hpp"
+
+#include <thread>
+
+using testing::make_pretty_test;
+using testing::TestGroup;
+
+
+// Whether two copies read from the same buffer, compared through const references so nothing detaches.
+bool sameBuffer(const SharedLimbs& a, const SharedLimbs& b) {
+    return !a.empty() && &a[0] == &b[0];
+}
+
+TestGroup all_tests[] = {
+    TestGroup("SharedLimbs",
+        make_pretty_test("copies share until written", [](auto& test) {
+            SharedLimbs a = {1, 2, 3};
+            test.check(!a.shared());
+            SharedLimbs b = a;
+            test.check(a.shared() && b.shared() && sameBuffer(a, b));
+            test.check(std::as_const(b)[1] == 2 && std::as_const(b).back() == 3 && b.size() == 3);
+            test.check(a == b && a.shared() && b.shared());
+
+            b[0] = 9;
+            test.check(!a.shared() && !b.shared() && !sameBuffer(a, b));
+            test.check(std::as_const(a)[0] == 1 && std::as_const(b)[0] == 9);
+
+            SharedLimbs c = a;
+            SharedLimbs d = a;
+            c.push_back(4);
+            test.check(!c.shared() && a.shared() && d.shared() && sameBuffer(a, d));
+            test.check(c.size() == 4 && a.size() == 3);
+
+            SharedLimbs empty;
+            SharedLimbs empty_copy = empty;
+            test.check(!empty.shared() && empty.empty() && empty == empty_copy);
+        }),
+
+        make_pretty_test("every write detaches", [](auto& test) {
+            const SharedLimbs original = {5, 6, 7};
+            auto detaches = [&](auto write) {
+                SharedLimbs copy = original;
+                write(copy);
+                bool same = !copy.shared() && !original.shared() && std::as_const(original)[0] == 5 &&
+                            original.size() == 3;
+                if (!same) {
+                    std::cout << "write left the copy shared or changed the original\n";
+                }
+                return same;
+            };
+            test.check(detaches([](SharedLimbs& x) { x[0] = 1; }));
+            test.check(detaches([](SharedLimbs& x) { x.back() = 1; }));
+            test.check(detaches([](SharedLimbs& x) { *x.begin() = 1; }));
+            test.check(detaches([](SharedLimbs& x) { x.push_back(1); }));
+            test.check(detaches([](SharedLimbs& x) { x.pop_back(); }));
+            test.check(detaches([](SharedLimbs& x) { x.resize(10); }));
+            test.check(detaches([](SharedLimbs& x) { x.reserve(100); }));
+            test.check(detaches([](SharedLimbs& x) { x.clear(); }));
+            test.check(detaches([](SharedLimbs& x) { x.assign(2, 8); }));
+            test.check(detaches([](SharedLimbs& x) { x.insert(std::as_const(x).begin(), 2, 0); }));
+            test.check(detaches([](SharedLimbs& x) { x.erase(std::as_const(x).begin(), std::as_const(x).end()); }));
+            test.check(detaches([](SharedLimbs& x) { static_cast<std::vector<long long>&>(x)[0] = 1; }));
+        })
+    ),
+
+    TestGroup("Shared BigInteger copies",
+        make_pretty_test("in-place operations leave copies intact", [](auto& test) {
+            for (int i = 0; i < 20; ++i) {
+                BigInteger a(randomDigits(randomSize()));
+                BigInteger b(randomNumber(300));
+                const std::string text = a.toString();
+                BigInteger copies[] = {a, a, a, a, a, a, a};
+                copies[0] += b;
+                copies[1] -= b;
+                copies[2] *= b;
+                copies[3] /= b;
+                copies[4] %= b;
+                ++copies[5];
+                copies[6] = -copies[6];
+                test.check(copies[0] == BigInteger(text) + b && copies[1] == BigInteger(text) - b);
+                test.check(copies[2] == BigInteger(text) * b && copies[3] == BigInteger(text) / b);
+                test.check(copies[4] == BigInteger(text) % b && copies[5] == BigInteger(text) + 1);
+                test.check(copies[6] == -BigInteger(text));
+                test.check(a.toString() == text);
+            }
+        }),
+
+        make_pretty_test("copies written on other threads", [](auto& test) {
+            BigInteger a(randomDigits(2000, false));
+            const std::string text = a.toString();
+            std::vector<BigInteger> results(4);
+            std::vector<std::thread> threads;
+            for (size_t t = 0; t < results.size(); ++t) {
+                threads.emplace_back([&a, &results, t] {
+                    for (int i = 0; i < 50; ++i) {
+                        BigInteger copy = a;
+                        copy += static_cast<long long>(t);
+                        results[t] = copy;
+                    }
+                });
+            }
+            for (auto& thread : threads) {
+                thread.join();
+            }
+            for (size_t t = 0; t < results.size(); ++t) {
+                test.check(results[t] == a + static_cast<long long>(t));
+            }
+            test.check(a.toString() == text);
+        })
+    )
+};
+
+
+int main() {
+    bool success = true;
+    for (auto& group : all_tests) {
+        success &= group.run();
+    }
+    return success ? 0 : 1;
+}